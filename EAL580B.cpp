@@ -1,5 +1,14 @@
 #include "EAL580B.h"
 #include "EAL580B_objDict.h"        // Object dictionary for L7NH drivers
+#include "EAL580B_SharedMemory.h"   // Shared memory publisher
+#include "EAL580B_Decimator.h"      // Decimating aggregation stage
+#include "EAL580B_History.h"        // Time-indexed position history
+#include "EAL580B_Failover.h"       // PDO to SDO failover
+#include "EAL580B_Mailbox.h"        // Mailbox ownership of slave
+#include <cstring>                  // For memcpy
+#include <cstdio>                   // For snprintf
+#include <cmath>                    // For llround
+#include <cstdlib>                  // For llabs
 
 // #######################################################################
 
@@ -9,11 +18,27 @@ using namespace EAL580B_Namespace;
 
 EAL580B::EAL580B()
 {
+    errorMessage = "";
+    _status = {EAL580B_OK, 0, 0, 0, 0};
+
     parameters.ETHERCAT_ID = -1;
     parameters.GEAR_RATIO = 0;
     parameters.PDOMAP_CONFIG_TYPE = 1;
+    parameters.PDO_SIGNALS = 0;
     parameters.ROTATION_DIR = 0;
     parameters.SPD_UNIT = SPD_UNIT_STEP_1000MS;
+    parameters.SAMPLE_DELAY_US = 0;
+    parameters.SYNC_MODE = SYNC_MODE_FREE_RUN;
+    parameters.SYNC_CYCLE_NS = 0;
+    parameters.GLITCH_MARGIN_STEP = 0;
+    parameters.GLITCH_REJECT = false;
+    parameters.SDO_TIMEOUT_INIT_US = 100000;
+    parameters.SDO_TIMEOUT_MIN_US = 2000;
+    parameters.SDO_TIMEOUT_MAX_US = EC_TIMEOUTRXM;
+    parameters.SDO_RETRIES = 2;
+    parameters.SDO_BACKOFF_US = 1000;
+    parameters.SDO_BREAKER_FAILS = 2;
+    parameters.SDO_BREAKER_OPEN_US = 1000000;
 
     value.pos2BytesDeg = 0;
     value.pos2BytesStep = 0;
@@ -22,12 +47,84 @@ EAL580B::EAL580B()
     value.posRawStep = 0;
     value.posStep = 0;
     value.velDegSec = 0;
+    value.velFiltDegSec = 0;
+    value.accDegSec2 = 0;
     value.velStep = 0;
+    value.status = SAMPLE_VALID;
+    value.systemTime = 0;
+    value.timeNs = 0;
+    value.cycle = 0;
+
+    sampleCounter = {0, 0, 0, 0, 0, 0, 0, 0};
 
     _oneRevolutionMaxSteps = 1;
     _totalMeasuringMaxRange = 1;
     _velConStep2DegSec = 1;
     _virtualOffset = 0;
+    _softOffset.store(0, std::memory_order_relaxed);
+    _identity = {0, 0, 0};
+    _recovering = false;
+    _recoveryFailed = false;
+    _reconfigFailed = false;
+    _recoveryStartNs = 0;
+    recoveryCounter = {0, 0, 0, 0};
+    _lastPosStep.store(0, std::memory_order_relaxed);
+    _presetExpect.store(0, std::memory_order_relaxed);
+    _presetWritten.store(_PRESET_IN_FLIGHT, std::memory_order_relaxed);
+    _presetBusy.store(0, std::memory_order_relaxed);
+    _glitchReset.store(false, std::memory_order_relaxed);
+    _presetPrevStep = 0;
+    _presetPrevDelta = 0;
+    _presetWait = 0;
+    _presetHistory = 0;
+    _recorder = nullptr;
+    _replay = nullptr;
+    _inputs = nullptr;
+    _publisher = nullptr;
+    _publisherSlot = 0;
+    _decimator = nullptr;
+    _decimatorSlot = 0;
+    _history = nullptr;
+    _failover = nullptr;
+    _failoverSlot = 0;
+    _degraded = false;
+    _failoverValidRun = 0;
+    _holdPosStep = 0;
+    _holdPosRawStep = 0;
+    _holdPos2BytesStep = 0;
+    _holdVelStep = 0;
+    _holdTimeNs = 0;
+
+    _deviceTimeNs = 0;
+    _minHostDeviceNs = 0;
+    _periodNs = 0;
+    _sampleDelayNs = 0;
+    _velEstDegSec = 0;
+    _prevPosStep = 0;
+    _prevPosValid = false;
+    _glitchPrevStep = 0;
+    _glitchPrevDelta = 0;
+    _glitchHistory = 0;
+    _glitchRun = 0;
+    _timingValid = false;
+
+    _sampleState = 0;
+    _sampleLost = false;
+    _sampleTimeNs = 0;
+    _snapshotCount.store(0, std::memory_order_relaxed);
+    _snapshots[0].seq.store(0, std::memory_order_relaxed);
+    _snapshots[1].seq.store(0, std::memory_order_relaxed);
+    _decodeSnapshot = {};
+
+    _TxPDO_rank = 0;
+    _TxPDO_bytes = 0;
+    _mappingText[0] = 0;
+
+    _syncMode = SYNC_MODE_FREE_RUN;
+    _syncCycleNs = 0;
+    _syncShiftNs = 0;
+
+    resetSdoTiming();
 }
 
 bool EAL580B::init(void)
@@ -56,6 +153,80 @@ bool EAL580B::init(void)
         return false;
     }
 
+    _initConversion();
+
+    if(!setSpeedMeasuringUnit(parameters.SPD_UNIT))
+    {
+        return false;
+    }
+
+    if( (parameters.SYNC_MODE != SYNC_MODE_FREE_RUN) && !setSyncMode(parameters.SYNC_MODE, parameters.SYNC_CYCLE_NS) )
+    {
+        return false;
+    }
+
+    if(parameters.PDO_SIGNALS != 0)
+    {
+        _TxPDOTableStruct table;
+
+        if( !_readTxPDOTable(table) || !_initTxSignals(table, true) )
+        {
+            return false;
+        }
+    }
+    else if(!_initTxMapping(true))
+    {
+        return false;
+    }
+
+    if(!_verifyTxMapping())
+    {
+        return false;
+    }
+
+    if(!_readIdentity(_identity))
+    {
+        return false;
+    }
+
+    // Identity of this init() is the new reference of recover().
+    _recoveryFailed = false;
+
+    return true;
+}
+
+bool EAL580B::initReplay(EAL580B_Replay* replay, uint32_t singleTurnResolution, uint32_t totalMeasuringRange)
+{
+    if(checkParameters() == false)
+    {
+        return false;
+    }
+
+    // Signal selection needs the mapping of the device. Replay has only the recorded inputs.
+    if( (replay == nullptr) || (singleTurnResolution == 0) || (totalMeasuringRange == 0) || (parameters.PDO_SIGNALS != 0) )
+    {
+        _setError(EAL580B_ERR_PARAMETER, "Error Encoder EAL580B: initReplay() arguments are not correct.");
+        return false;
+    }
+
+    _oneRevolutionMaxSteps = singleTurnResolution;
+    _totalMeasuringMaxRange = totalMeasuringRange;
+
+    _initConversion();
+
+    if(!_initTxMapping(false))
+    {
+        return false;
+    }
+
+    _replay = replay;
+    _inputs = replay->getInputs();
+
+    return true;
+}
+
+void EAL580B::_initConversion(void)
+{
     _virtualOffset = _totalMeasuringMaxRange/2;
 
     switch(parameters.SPD_UNIT)
@@ -75,253 +246,635 @@ bool EAL580B::init(void)
         default:
             _velConStep2DegSec = 1.0;
     }
+}
 
-    if(!setSpeedMeasuringUnit(parameters.SPD_UNIT))
-    {
-        return false;
-    }
-
+bool EAL580B::_initTxMapping(bool assign)
+{
     uint32_t mapping_value[10];
+    uint8_t num_enteries;
+    int pdo_rank;
 
     switch(parameters.PDOMAP_CONFIG_TYPE)
     {
         case 1:    
-            if(assignTxPDO_rank(1) == FALSE)
-            {
-                return false;
-            }
-                
+            pdo_rank = 1;
             mapping_value[0] = MapValue_PositionValue;
-            if(!_setTxPDO(1, mapping_value))
-            {
-                return false;
-            }
+            num_enteries = 1;
         break;
         case 2:    
-            if(assignTxPDO_rank(2) == FALSE)
-            {
-                return false;
-            }
-            
+            pdo_rank = 2;
             mapping_value[0] = MapValue_PositionValue;
             mapping_value[1] = MapValue_SpeedValue4Bytes;
-            if(!_setTxPDO(2, mapping_value))
-            {
-                return false;
-            }
+            num_enteries = 2;
         break;
         case 3:  
-            if(assignTxPDO_rank(4) == FALSE)
-            {
-                return false;
-            }
-
+            pdo_rank = 4;
             mapping_value[0] = MapValue_PositionRawValue;
-            if(!_setTxPDO(1, mapping_value))
-            {
-                return false;
-            }
+            num_enteries = 1;
         break;
         case 4:
-            if(assignTxPDO_rank(7) == FALSE)
-            {
-                return false;
-            }
-
+            pdo_rank = 7;
             mapping_value[0] = MapValue_PositionValue2Bytes;
-            if(!_setTxPDO(1, mapping_value))
-            {
-                return false;
-            }
+            num_enteries = 1;
         break;
         default:
-            errorMessage = "Error Encoder: init() was not successed.";
+            _setError(EAL580B_ERR_PARAMETER, "Error Encoder: init() was not successed.");
             return false;
     }
 
-    return true;
-}
+    if(assign && (assignTxPDO_rank(pdo_rank) == FALSE))
+    {
+        return false;
+    }
 
-bool EAL580B::checkParameters(void)
-{
-    bool state = (parameters.ETHERCAT_ID > 0) &&
-                 (parameters.GEAR_RATIO >= 0) &&
-                 (parameters.PDOMAP_CONFIG_TYPE >= 1) && (parameters.PDOMAP_CONFIG_TYPE <= 4) &&
-                 (parameters.ROTATION_DIR <= 1) &&
-                 (parameters.SPD_UNIT <= 3); 
+    _TxPDO_rank = pdo_rank;
 
-    if(state == false)
+    if(!_setTxPDO(num_enteries, mapping_value))
     {
-        errorMessage = "Error Encoder EAL580B: One or some parameters are not correct.";
         return false;
     }
 
     return true;
 }
 
-bool EAL580B::assignTxPDO_rank(int pdo_rank)
+// Return PDO_SIGNAL_xxx of a TxPDO mapping entry. 0 for other objects.
+static uint8_t signalOfEntry(uint32_t entry)
 {
-    // Read state of all slaves in ethercat.
-    ec_readstate();
-
-    if(ec_slave[parameters.ETHERCAT_ID].state != EC_STATE_PRE_OP)
+    switch(entry)
     {
-        errorMessage = "Error Encoder EAL580B: Assign TxPDO rank not successed beacuse salve not in pre operational state.";
-        return FALSE;
+        case MapValue_SystemTime:               return PDO_SIGNAL_SYSTEM_TIME;
+        case MapValue_PositionValue2Bytes:      return PDO_SIGNAL_POSITION_2BYTES;
+        case MapValue_SpeedValue4Bytes:         return PDO_SIGNAL_SPEED;
+        case MapValue_SensorTemperature:        return PDO_SIGNAL_TEMPERATURE;
+        case MapValue_PositionValue:            return PDO_SIGNAL_POSITION;
+        case MapValue_PositionRawValue:         return PDO_SIGNAL_POSITION_RAW;
+        default:                                return 0;
     }
-        
-    int wkc;                // Working counter     
-    uint16_t index;         // Certain index for assign in syncManager    
-    uint8_t data;
+}
 
-    switch(pdo_rank)
+bool EAL580B::_readTxPDOMapping(int pdo_rank, uint8_t &num, uint32_t* entries)
+{
+    uint16_t index = Index_TPDOmapping_1 + (pdo_rank - 1);
+    int size = 1;
+
+    num = 0;
+
+    if( (_SDOread(index, 0, &size, &num) <= 0) || (num == 0) || (num > _TXPDO_ENTRY_MAX) )
     {
-        case 1:
-            index = Index_TPDOmapping_1;
-        break;
-        case 2:
-            index = Index_TPDOmapping_2;
-        break;
-        case 3:
-            index = Index_TPDOmapping_3;
-        break;
-        case 4:
-            index = Index_TPDOmapping_4;
-        break;
-        case 5:
-            index = Index_TPDOmapping_5;
-        break;
-        case 6:
-            index = Index_TPDOmapping_6;
-        break;
-        case 7:
-            index = Index_TPDOmapping_7;
-        break;
-        default:
-            errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
-            return false;
+        return false;
     }
 
-    data = 0;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_SyncManager3PDOAssignment, 0, FALSE, 1, &data, EC_TIMEOUTRXM);
-    osal_usleep(10000);
-
-    if(wkc <= 0)
+    for(int subindex = 1; subindex <= num; subindex++)
     {
-        errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
-        return FALSE;
+        size = 4;
+
+        if( (_SDOread(index, subindex, &size, &entries[subindex - 1]) <= 0) || (size != 4) )
+        {
+            return false;
+        }
     }
-        
 
-    // Assign TxPDO index.
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_SyncManager3PDOAssignment, 1, FALSE, 2, &index, EC_TIMEOUTRXM);
-    osal_usleep(10000);
+    return true;
+}
 
-    if(wkc <= 0)
+bool EAL580B::_readTxPDOTable(_TxPDOTableStruct &table)
+{
+    bool found = false;
+
+    for(int rank = 1; rank <= _TXPDO_RANK_NUM; rank++)
     {
-        errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
-        return FALSE;
-    }
+        uint8_t num;
 
-    data = 1;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_SyncManager3PDOAssignment, 0, FALSE, 1, &data, EC_TIMEOUTRXM);
-    osal_usleep(10000);
+        // A rank that can not be read is just not selected.
+        if(_readTxPDOMapping(rank, num, table.entry[rank - 1]))
+        {
+            table.num[rank - 1] = num;
+            found = true;
+        }
+        else
+        {
+            table.num[rank - 1] = 0;
+        }
+    }
 
-    if(wkc <= 0)
+    if(!found)
     {
-        errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
-        return FALSE;
+        _setError(EAL580B_ERR_MAPPING, "Error Encoder EAL580B: TxPDO mapping can not be read from device.");
     }
-        
-    _TxPDO_rank = pdo_rank;
-    return TRUE;
+
+    return found;
 }
 
-uint16_t EAL580B::getTxPDO_rank(void)
+bool EAL580B::_verifyTxMapping(void)
 {
-    int wkc;
-    int size = 2;
-    uint16_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_SyncManager3PDOAssignment, 1, FALSE, &size, &data, EC_TIMEOUTRXM);
+    uint8_t assignedNum = 0;
+    uint16_t assignedIndex = 0;
+    uint8_t num = 0;
+    uint32_t entries[_TXPDO_ENTRY_MAX];
 
-    if(wkc <= 0)
+    if( !readObjects<EAL580B_OD::SyncManager3PDOAssignmentNum, EAL580B_OD::SyncManager3PDOAssignment>(&assignedNum, &assignedIndex).ok() )
     {
-        errorMessage = "Error Encoder EAL580B: SDO write not successed.";
-        return FALSE;
+        return false;
     }
 
-    return data;
+    if(!_readTxPDOMapping(_TxPDO_rank, num, entries))
+    {
+        snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: TxPDO mapping 0x%04X can not be read.", (unsigned)(Index_TPDOmapping_1 + _TxPDO_rank - 1));
+        _setError(EAL580B_ERR_MAPPING, _mappingText);
+        return false;
+    }
+
+    return _checkTxMapping(assignedNum, assignedIndex, num, entries);
 }
 
-bool EAL580B::_setTxPDO(uint8_t num_enteries, uint32_t* mapping_entry)
+bool EAL580B::_checkTxMapping(uint8_t assignedNum, uint16_t assignedIndex, uint8_t num, const uint32_t* entries)
 {
-    _TxMapFlag[0] = 0;
-    _TxMapFlag[1] = 0;
-    _TxMapFlag[2] = 0;
-    _TxMapFlag[3] = 0;
-    _TxMapFlag[4] = 0;
-    _TxMapFlag[5] = 0;
+    static const char* const names[6] = {"SystemTime", "PositionValue2Bytes", "SpeedValue4Bytes", "SensorTemperature", "PositionValue", "PositionRawValue"};
+    const uint8_t offsets[6] = {_TxMapOffset_SystemTime, _TxMapOffset_PositionValue2Bytes, _TxMapOffset_SpeedValue4Bytes,
+                                _TxMapOffset_SensorTemperature, _TxMapOffset_PositionValue, _TxMapOffset_PositionRawValue};
+    uint16_t expectedIndex = Index_TPDOmapping_1 + (_TxPDO_rank - 1);
 
-    // **Note: TxPDO of encoder is just read only access. So it must be at comment some bellow sections:
+    if( (assignedNum != 1) || (assignedIndex != expectedIndex) )
+    {
+        snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: 0x1C13 assigns %u PDO(s), first 0x%04X. Expected 1 PDO 0x%04X.",
+                 (unsigned)assignedNum, (unsigned)assignedIndex, (unsigned)expectedIndex);
+        _setError(EAL580B_ERR_MAPPING, _mappingText);
+        return false;
+    }
 
-    // ------------------------------------------------------
-    // int wkc;
-    // uint16_t index;
+    uint8_t seen = 0;
+    uint16_t offset = 0;
 
-    // switch(_TxPDO_rank)
-    // {
-    //     case 1:
-    //         index = Index_TPDOmapping_1;
-    //     break;
-    //     case 2:
-    //         index = Index_TPDOmapping_2;
-    //     break;
-    //     case 3:
-    //         index = Index_TPDOmapping_3;
-    //     break;
-    //     case 4:
-    //         index = Index_TPDOmapping_4;
-    //     break;
-    //     case 5:
-    //         index = Index_TPDOmapping_5;
-    //     break;
-    //     case 6:
-    //         index = Index_TPDOmapping_6;
-    //     break;
-    //     case 7:
-    //         index = Index_TPDOmapping_7;
-    //     break;
-    //     default:
-    //         return FALSE;
-    // }
+    for(int i = 0; i < num; i++)
+    {
+        uint8_t signal = signalOfEntry(entries[i]);
+        uint8_t bits = entries[i] & 0xFF;
 
-    // wkc = ec_SDOwrite(parameters.ETHERCAT_ID, index, 0, FALSE, 1, &num_enteries, EC_TIMEOUTRXM);
+        if( (bits == 0) || ((bits & 0x07) != 0) )
+        {
+            snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: 0x%04X:%d = 0x%08X is not byte aligned.",
+                     (unsigned)expectedIndex, i + 1, (unsigned)entries[i]);
+            _setError(EAL580B_ERR_MAPPING, _mappingText);
+            return false;
+        }
 
-    // if(wkc <= 0)
-    //     return FALSE;
+        for(int j = 0; j < 6; j++)
+        {
+            if(signal != (1 << j))
+            {
+                continue;
+            }
 
-    // ---------------------------------------------------------------
+            if( (_TxMapFlag[j] == 0) || (offsets[j] != offset) )
+            {
+                snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: 0x%04X:%d %s is at byte %u. Decoder uses %s %u.",
+                         (unsigned)expectedIndex, i + 1, names[j], (unsigned)offset, (_TxMapFlag[j] != 0) ? "byte" : "not mapped", (unsigned)offsets[j]);
+                _setError(EAL580B_ERR_MAPPING, _mappingText);
+                return false;
+            }
 
-    uint8_t offset = 0;
+            seen |= signal;
+        }
 
-    for(int subindex=1; subindex <= num_enteries; subindex++)
-    {
-        // ** Note: TxPDO just read only access!
-        // --------------------------------------------------------------------
-        // wkc = ec_SDOwrite(parameters.ETHERCAT_ID, index, subindex, FALSE, 4, &mapping_entry[subindex - 1], EC_TIMEOUTRXM);
-        // osal_usleep(10000);   // delay 10ms
+        offset += bits / 8;
+    }
 
-        // if(wkc <= 0)
-        // {  
-        //     return FALSE;
-        // }
-        // --------------------------------------------------------------------
+    uint8_t missing = getMappedSignals() & ~seen;
 
-        switch(mapping_entry[subindex - 1])
+    for(int j = 0; j < 6; j++)
+    {
+        if((missing & (1 << j)) != 0)
         {
-            case MapValue_SystemTime:
-                _TxMapOffset_SystemTime = offset;
-                _TxMapFlag[0] = 1;
+            snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: %s is decoded at byte %u but not in 0x%04X of device.",
+                     names[j], (unsigned)offsets[j], (unsigned)expectedIndex);
+            _setError(EAL580B_ERR_MAPPING, _mappingText);
+            return false;
+        }
+    }
+
+    _TxPDO_bytes = offset;
+
+    return true;
+}
+
+bool EAL580B::verifyTxPDO(void)
+{
+    if(_replay != nullptr)
+    {
+        return true;
+    }
+
+    const ec_slavet &slave = ec_slave[parameters.ETHERCAT_ID];
+
+    if(slave.Ibytes != _TxPDO_bytes)
+    {
+        snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: Slave input size is %u bytes. TxPDO 0x%04X has %u bytes.",
+                 (unsigned)slave.Ibytes, (unsigned)(Index_TPDOmapping_1 + _TxPDO_rank - 1), (unsigned)_TxPDO_bytes);
+        _setError(EAL580B_ERR_MAPPING, _mappingText);
+        return false;
+    }
+
+    // SMlength is 0 if SM3 is not used for inputs. Then Ibytes check above is enough.
+    if( (slave.SM[3].SMlength != 0) && (slave.SM[3].SMlength != _TxPDO_bytes) )
+    {
+        snprintf(_mappingText, sizeof(_mappingText), "Error Encoder EAL580B: SM3 length is %u bytes. TxPDO 0x%04X has %u bytes.",
+                 (unsigned)slave.SM[3].SMlength, (unsigned)(Index_TPDOmapping_1 + _TxPDO_rank - 1), (unsigned)_TxPDO_bytes);
+        _setError(EAL580B_ERR_MAPPING, _mappingText);
+        return false;
+    }
+
+    return true;
+}
+
+bool EAL580B::setSyncMode(uint8_t mode, uint32_t cycleTimeNs, int32_t sync0ShiftNs)
+{
+    if( (mode > SYNC_MODE_DC) || ((mode != SYNC_MODE_FREE_RUN) && (cycleTimeNs == 0)) )
+    {
+        _setError(EAL580B_ERR_PARAMETER, "Error Encoder EAL580B: setSyncMode() was not successed. Mode or cycle time is not correct.");
+        return false;
+    }
+
+    uint16_t supported = 0;
+
+    if( (mode != SYNC_MODE_FREE_RUN) && !readObject<EAL580B_OD::SyncTypesSupported>(&supported).ok() )
+    {
+        errorMessage = "Error Encoder EAL580B: setSyncMode() was not successed.";
+        return false;
+    }
+
+    if(!_checkSyncType(mode, supported))
+    {
+        return false;
+    }
+
+    if(!writeObject<EAL580B_OD::SyncType>(mode).ok())
+    {
+        errorMessage = "Error Encoder EAL580B: setSyncMode() was not successed.";
+        return false;
+    }
+
+    // Speed value (0x2004) is calculated with this cycle time in SM3 mode.
+    if( (mode == SYNC_MODE_SM3) && !writeObject<EAL580B_OD::SpeedCalculationCycleTime>(cycleTimeNs / 1000).ok() )
+    {
+        errorMessage = "Error Encoder EAL580B: setSyncMode() was not successed.";
+        return false;
+    }
+
+    // Read back. Device may accept the write but keep another mode.
+    uint16_t type = 0;
+    uint32_t speedCycle = cycleTimeNs / 1000;
+
+    if(!readObject<EAL580B_OD::SyncType>(&type).ok() ||
+       ((mode == SYNC_MODE_SM3) && !readObject<EAL580B_OD::SpeedCalculationCycleTime>(&speedCycle).ok()) )
+    {
+        errorMessage = "Error Encoder EAL580B: setSyncMode() was not successed.";
+        return false;
+    }
+
+    if( (type != mode) || (speedCycle != cycleTimeNs / 1000) )
+    {
+        _setError(EAL580B_ERR_SYNC, "Error Encoder EAL580B: setSyncMode() was not successed. Read back value is different.");
+        return false;
+    }
+
+    _applySyncMode(mode, cycleTimeNs, sync0ShiftNs);
+
+    return true;
+}
+
+bool EAL580B::_checkSyncType(uint8_t mode, uint16_t supported)
+{
+    // 0x1C33:4 bit 1: synchronous supported. Bits 2..4: DC types supported.
+    if( ((mode == SYNC_MODE_SM3) && ((supported & 0x0002) == 0)) ||
+        ((mode == SYNC_MODE_DC) && (((supported >> 2) & 0x07) == 0)) )
+    {
+        _setError(EAL580B_ERR_SYNC, "Error Encoder EAL580B: setSyncMode() was not successed. Mode is not supported by device.");
+        return false;
+    }
+
+    return true;
+}
+
+void EAL580B::_applySyncMode(uint8_t mode, uint32_t cycleTimeNs, int32_t sync0ShiftNs)
+{
+    _syncMode = mode;
+    _syncCycleNs = cycleTimeNs;
+    _syncShiftNs = sync0ShiftNs;
+
+    if(mode == SYNC_MODE_DC)
+    {
+        ec_dcsync0(parameters.ETHERCAT_ID, TRUE, cycleTimeNs, sync0ShiftNs);
+    }
+    else if(ec_slave[parameters.ETHERCAT_ID].hasdc)
+    {
+        ec_dcsync0(parameters.ETHERCAT_ID, FALSE, 0, 0);
+    }
+}
+
+bool EAL580B::getSyncReport(SyncReportStruct &report)
+{
+    SyncReportStruct data = {};
+
+    if(!readObjects<EAL580B_OD::SyncType, EAL580B_OD::SyncCycleTime, EAL580B_OD::SyncShiftTime, EAL580B_OD::SyncCalcCopyTime>(
+            &data.mode, &data.cycleTimeNs, &data.shiftTimeNs, &data.calcCopyTimeNs).ok())
+    {
+        errorMessage = "Error Encoder EAL580B: getSyncReport() was not successed.";
+        return false;
+    }
+
+    // Diagnostic subindexes are optional for devices. Missing ones stay 0.
+    readObject<EAL580B_OD::SyncCycleTimeTooSmall>(&data.cycleTimeTooSmall);
+    readObject<EAL580B_OD::SyncError>(&data.syncError);
+
+    data.sampleOffsetNs = _sampleOffsetNs(data.shiftTimeNs, data.calcCopyTimeNs);
+    report = data;
+
+    return true;
+}
+
+int64_t EAL580B::_sampleOffsetNs(uint32_t shiftTimeNs, uint32_t calcCopyTimeNs) const
+{
+    int64_t cycle = _syncCycleNs;
+
+    switch(_syncMode)
+    {
+        case SYNC_MODE_SM3:
+            // Input is latched at SM3 event of previous frame.
+            return cycle;
+        case SYNC_MODE_DC:
+        {
+            // SYNC0 fires at DC times k * cycle + SYNC0 shift. Input latch is shiftTimeNs later.
+            // The frame reads the latest latch that finished calc and copy before it.
+            int64_t latchPhase = ((int64_t)_syncShiftNs + shiftTimeNs) % cycle;
+            int64_t framePhase = ec_DCtime % cycle;
+            int64_t offset = ((framePhase - latchPhase) % cycle + cycle) % cycle;
+
+            while(offset < (int64_t)calcCopyTimeNs)
+            {
+                offset += cycle;
+            }
+
+            return offset;
+        }
+        default:
+            return -1;
+    }
+}
+
+int EAL580B::_selectTxPDO(const _TxPDOTableStruct &table, uint8_t signals)
+{
+    int bestRank = 0;
+    uint32_t bestBits = UINT32_MAX;
+
+    for(int rank = 1; rank <= _TXPDO_RANK_NUM; rank++)
+    {
+        uint8_t covered = 0;
+        uint32_t bits = 0;
+
+        for(int i = 0; i < table.num[rank - 1]; i++)
+        {
+            covered |= signalOfEntry(table.entry[rank - 1][i]);
+            bits += table.entry[rank - 1][i] & 0xFF;
+        }
+
+        // Fewest bytes wins. Lower rank wins a tie.
+        if( (table.num[rank - 1] != 0) && ((covered & signals) == signals) && (bits < bestBits) )
+        {
+            bestRank = rank;
+            bestBits = bits;
+        }
+    }
+
+    return bestRank;
+}
+
+bool EAL580B::_initTxSignals(const _TxPDOTableStruct &table, bool assign)
+{
+    int pdo_rank = _selectTxPDO(table, parameters.PDO_SIGNALS);
+
+    if(pdo_rank == 0)
+    {
+        _setError(EAL580B_ERR_MAPPING, "Error Encoder EAL580B: No TxPDO rank covers the requested signals.");
+        return false;
+    }
+
+    if(assign && (assignTxPDO_rank(pdo_rank) == FALSE))
+    {
+        return false;
+    }
+
+    _TxPDO_rank = pdo_rank;
+
+    // Copy, because _setTxPDO() takes a mutable array.
+    uint32_t mapping_value[_TXPDO_ENTRY_MAX];
+    uint8_t num_enteries = table.num[pdo_rank - 1];
+
+    for(int i = 0; i < num_enteries; i++)
+    {
+        mapping_value[i] = table.entry[pdo_rank - 1][i];
+    }
+
+    return _setTxPDO(num_enteries, mapping_value);
+}
+
+bool EAL580B::checkParameters(void)
+{
+    bool state = (parameters.ETHERCAT_ID > 0) &&
+                 (parameters.GEAR_RATIO >= 0) &&
+                 ( (parameters.PDO_SIGNALS != 0) || ((parameters.PDOMAP_CONFIG_TYPE >= 1) && (parameters.PDOMAP_CONFIG_TYPE <= 4)) ) &&
+                 (parameters.PDO_SIGNALS <= PDO_SIGNAL_ALL) &&
+                 (parameters.ROTATION_DIR <= 1) &&
+                 (parameters.SPD_UNIT <= 3) &&
+                 (parameters.SYNC_MODE <= SYNC_MODE_DC) &&
+                 ( (parameters.SYNC_MODE == SYNC_MODE_FREE_RUN) || (parameters.SYNC_CYCLE_NS > 0) ) &&
+                 (parameters.SDO_TIMEOUT_MIN_US > 0) &&
+                 (parameters.SDO_TIMEOUT_MIN_US <= parameters.SDO_TIMEOUT_INIT_US) &&
+                 (parameters.SDO_TIMEOUT_INIT_US <= parameters.SDO_TIMEOUT_MAX_US); 
+
+    if(state == false)
+    {
+        _setError(EAL580B_ERR_PARAMETER, "Error Encoder EAL580B: One or some parameters are not correct.");
+        return false;
+    }
+
+    return true;
+}
+
+bool EAL580B::assignTxPDO_rank(int pdo_rank)
+{
+    // Read state of all slaves in ethercat.
+    ec_readstate();
+
+    if(ec_slave[parameters.ETHERCAT_ID].state != EC_STATE_PRE_OP)
+    {
+        _setError(EAL580B_ERR_STATE, "Error Encoder EAL580B: Assign TxPDO rank not successed beacuse salve not in pre operational state.");
+        return FALSE;
+    }
+        
+    EAL580B_Status status;
+    uint16_t index;         // Certain index for assign in syncManager    
+    uint8_t data;
+
+    switch(pdo_rank)
+    {
+        case 1:
+            index = Index_TPDOmapping_1;
+        break;
+        case 2:
+            index = Index_TPDOmapping_2;
+        break;
+        case 3:
+            index = Index_TPDOmapping_3;
+        break;
+        case 4:
+            index = Index_TPDOmapping_4;
+        break;
+        case 5:
+            index = Index_TPDOmapping_5;
+        break;
+        case 6:
+            index = Index_TPDOmapping_6;
+        break;
+        case 7:
+            index = Index_TPDOmapping_7;
+        break;
+        default:
+            _setError(EAL580B_ERR_PARAMETER, "Error Encoder: assignTxPDO_rank() was not successed.");
+            return false;
+    }
+
+    data = 0;
+    status = writeObject<EAL580B_OD::SyncManager3PDOAssignmentNum>(data);
+    osal_usleep(10000);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
+        return FALSE;
+    }
+        
+
+    // Assign TxPDO index.
+    status = writeObject<EAL580B_OD::SyncManager3PDOAssignment>(index);
+    osal_usleep(10000);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
+        return FALSE;
+    }
+
+    data = 1;
+    status = writeObject<EAL580B_OD::SyncManager3PDOAssignmentNum>(data);
+    osal_usleep(10000);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder: assignTxPDO_rank() was not successed.";
+        return FALSE;
+    }
+        
+    _TxPDO_rank = pdo_rank;
+    return TRUE;
+}
+
+uint16_t EAL580B::getTxPDO_rank(void)
+{
+    uint16_t data = 0;
+    getTxPDO_rank(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getTxPDO_rank(uint16_t* data)
+{
+    return readObject<EAL580B_OD::SyncManager3PDOAssignment>(data);
+}
+
+uint8_t EAL580B::getMappedSignals(void) const
+{
+    uint8_t signals = 0;
+
+    // _TxMapFlag indexes are in the same order as PDO_SIGNAL_xxx bits.
+    for(int i = 0; i < 6; i++)
+    {
+        if(_TxMapFlag[i] != 0)
+        {
+            signals |= (1 << i);
+        }
+    }
+
+    return signals;
+}
+
+bool EAL580B::_setTxPDO(uint8_t num_enteries, uint32_t* mapping_entry)
+{
+    _TxMapFlag[0] = 0;
+    _TxMapFlag[1] = 0;
+    _TxMapFlag[2] = 0;
+    _TxMapFlag[3] = 0;
+    _TxMapFlag[4] = 0;
+    _TxMapFlag[5] = 0;
+
+    // **Note: TxPDO of encoder is just read only access. So it must be at comment some bellow sections:
+
+    // ------------------------------------------------------
+    // int wkc;
+    // uint16_t index;
+
+    // switch(_TxPDO_rank)
+    // {
+    //     case 1:
+    //         index = Index_TPDOmapping_1;
+    //     break;
+    //     case 2:
+    //         index = Index_TPDOmapping_2;
+    //     break;
+    //     case 3:
+    //         index = Index_TPDOmapping_3;
+    //     break;
+    //     case 4:
+    //         index = Index_TPDOmapping_4;
+    //     break;
+    //     case 5:
+    //         index = Index_TPDOmapping_5;
+    //     break;
+    //     case 6:
+    //         index = Index_TPDOmapping_6;
+    //     break;
+    //     case 7:
+    //         index = Index_TPDOmapping_7;
+    //     break;
+    //     default:
+    //         return FALSE;
+    // }
+
+    // wkc = ec_SDOwrite(parameters.ETHERCAT_ID, index, 0, FALSE, 1, &num_enteries, EC_TIMEOUTRXM);
+
+    // if(wkc <= 0)
+    //     return FALSE;
+
+    // ---------------------------------------------------------------
+
+    uint8_t offset = 0;
+
+    for(int subindex=1; subindex <= num_enteries; subindex++)
+    {
+        // ** Note: TxPDO just read only access!
+        // --------------------------------------------------------------------
+        // wkc = ec_SDOwrite(parameters.ETHERCAT_ID, index, subindex, FALSE, 4, &mapping_entry[subindex - 1], EC_TIMEOUTRXM);
+        // osal_usleep(10000);   // delay 10ms
+
+        // if(wkc <= 0)
+        // {  
+        //     return FALSE;
+        // }
+        // --------------------------------------------------------------------
+
+        switch(mapping_entry[subindex - 1])
+        {
+            case MapValue_SystemTime:
+                _TxMapOffset_SystemTime = offset;
+                _TxMapFlag[0] = 1;
                 offset += 4;
             break;
             case MapValue_PositionValue2Bytes:
@@ -350,433 +903,1640 @@ bool EAL580B::_setTxPDO(uint8_t num_enteries, uint32_t* mapping_entry)
                 offset += 4;
             break;
             default:
-                errorMessage = "Error Encoder: _setTxPDO() was not successed.";
-                return FALSE;
+                // Other object. Skip it by bit length. Only byte aligned objects are supported.
+                if( ((mapping_entry[subindex - 1] & 0xFF) == 0) || ((mapping_entry[subindex - 1] & 0x07) != 0) )
+                {
+                    _setError(EAL580B_ERR_MAPPING, "Error Encoder: _setTxPDO() was not successed.");
+                    return FALSE;
+                }
+
+                offset += (mapping_entry[subindex - 1] & 0xFF) / 8;
+            break;
+        }
+    
+    }
+
+    return true;
+}
+
+void EAL580B::_updateValuesConversion(void)
+{
+    value.pos2BytesDeg = 360.0 * (double)value.pos2BytesStep / (double)_oneRevolutionMaxSteps;
+    int64_t softOffset = _softOffset.load(std::memory_order_acquire);
+
+    _lastPosStep.store(value.posStep, std::memory_order_relaxed);
+
+    value.posDeg = 360.0 * ((double)value.posStep - (double)_virtualOffset - (double)softOffset) / (double)_oneRevolutionMaxSteps;
+    value.posRawDeg = 360.0 * (double)value.posRawStep / (double)_oneRevolutionMaxSteps;
+    value.velDegSec = _velConStep2DegSec * (double)value.velStep;
+
+    if(parameters.GEAR_RATIO > 0)
+    {
+        value.posDeg =  (double)parameters.GEAR_RATIO * value.posDeg;
+        value.velDegSec = (double)parameters.GEAR_RATIO * value.velDegSec;
+    }
+}
+
+void EAL580B::_updateValuesTiming(bool useSystemTime)
+{
+    // Replay samples keep recorded time. So extrapolation behaves as at recording time.
+    uint64_t timeNs = (_replay != nullptr) ? _replay->getRecord().timeNs : ((_sampleTimeNs != 0) ? _sampleTimeNs : nowNs());
+
+    if(_timingValid && (timeNs > value.timeNs))
+    {
+        double dt = (double)(timeNs - value.timeNs);
+
+        // Slow first order filters. Jitter of host timing should not reach velocity and delay estimation.
+        _periodNs = (_periodNs == 0) ? dt : (0.99 * _periodNs + 0.01 * dt);
+
+        // Only differences of two consecutive valid samples. Not valid, glitch and degraded positions are no reference.
+        if( _prevPosValid && (value.status == SAMPLE_VALID) )
+        {
+            int64_t delta = (int64_t)value.posStep - (int64_t)_prevPosStep;
+            int64_t range = _totalMeasuringMaxRange;
+
+            if(range > 0)
+            {
+                delta = (delta > range / 2) ? (delta - range) : ((delta < -range / 2) ? (delta + range) : delta);
+            }
+
+            double deltaDeg = 360.0 * (double)delta / (double)_oneRevolutionMaxSteps;
+
+            if(parameters.GEAR_RATIO > 0)
+            {
+                deltaDeg = (double)parameters.GEAR_RATIO * deltaDeg;
+            }
+
+            _velEstDegSec = 0.8 * _velEstDegSec + 0.2 * deltaDeg * 1e9 / dt;
+        }
+    }
+
+    if(useSystemTime && (_TxMapFlag[0] != 0))
+    {
+        // SystemTime is the lower 32 bits of encoder system time in [ns]. Unwrap it.
+        if(_timingValid)
+        {
+            _deviceTimeNs += (uint32_t)(value.systemTime - (uint32_t)_deviceTimeNs);
+        }
+        else
+        {
+            _deviceTimeNs = value.systemTime;
+        }
+
+        int64_t hostDevice = (int64_t)timeNs - (int64_t)_deviceTimeNs;
+
+        // Minimum tracks clock offset plus minimum latency. It leaks upward by 100 ppm of period to follow clock drift.
+        if( !_timingValid || (hostDevice < _minHostDeviceNs) )
+        {
+            _minHostDeviceNs = hostDevice;
+        }
+        else
+        {
+            _minHostDeviceNs += (int64_t)(_periodNs * 1e-4) + 1;
+        }
+
+        _sampleDelayNs = (uint64_t)(hostDevice - _minHostDeviceNs);
+    }
+    else
+    {
+        _sampleDelayNs = (uint64_t)(0.5 * _periodNs);
+    }
+
+    _sampleDelayNs += (uint64_t)parameters.SAMPLE_DELAY_US * 1000;
+
+    value.timeNs = timeNs;
+    _prevPosStep = value.posStep;
+    _prevPosValid = (value.status == SAMPLE_VALID);
+    _timingValid = true;
+}
+
+double EAL580B::getVelocityDegSec(void) const
+{
+    if(_TxMapFlag[2] != 0)
+    {
+        return value.velDegSec;
+    }
+
+    return _velEstDegSec;
+}
+
+double EAL580B::getPositionDegAt(uint64_t hostTimeNs)
+{
+    double horizonSec = ((double)hostTimeNs - ((double)value.timeNs - (double)_sampleDelayNs)) * 1e-9;
+
+    return value.posDeg + getVelocityDegSec() * horizonSec;
+}
+
+uint64_t EAL580B::nowNs(void)
+{
+    return EAL580B_nowNs();
+}
+
+void EAL580B::_updateValuesConsumers(void)
+{
+    if(positionCompare.getEdgeCount() > 0)
+    {
+        // Not valid and held positions are no motion. First valid position after the gap only latches,
+        // so the gap is not a crossing.
+        if((value.status & (SAMPLE_STALE_WKC | SAMPLE_NOT_OP | SAMPLE_FROZEN | SAMPLE_GLITCH | SAMPLE_HELD)) == 0)
+        {
+            positionCompare.update(value.posDeg);
+        }
+        else
+        {
+            positionCompare.reset();
+        }
+    }
+
+    if(_recorder != nullptr)
+    {
+        EAL580B_Recorder::RecordStruct record;
+
+        // Sample instant. Replay feeds it back into value.timeNs.
+        record.timeNs = value.timeNs;
+        record.posStep = value.posStep;
+        record.posRawStep = value.posRawStep;
+        record.velStep = value.velStep;
+        record.status = (uint16_t)((value.status << 8) | (_sampleState & 0xFF));
+        record.slaveId = (uint16_t)parameters.ETHERCAT_ID;
+
+        uint8 *inputs = _getInputs();
+        uint32_t inputSize = (_replay != nullptr) ? _replay->getInputSize() : ec_slave[parameters.ETHERCAT_ID].Ibytes;
+
+        if( (inputs == nullptr) || (inputSize > sizeof(record.inputs)) )
+        {
+            inputSize = 0;
+        }
+
+        record.inputSize = (uint8_t)inputSize;
+        memcpy(record.inputs, inputs, inputSize);
+
+        _recorder->record(record);
+    }
+
+    if(_publisher != nullptr)
+    {
+        _publisher->publish(_publisherSlot, parameters.ETHERCAT_ID, value);
+    }
+
+    // Held sample is no new sample for time based consumers.
+    if((value.status & SAMPLE_HELD) != 0)
+    {
+        return;
+    }
+
+    if(_decimator != nullptr)
+    {
+        _decimator->push(_decimatorSlot, value);
+    }
+
+    if(_history != nullptr)
+    {
+        _history->push(value.timeNs - _sampleDelayNs, value.posDeg, value.velDegSec, value.status);
+    }
+}
+
+int EAL580B::_SDOread(uint16_t index, uint8_t subindex, int* size, void* data)
+{
+    return _SDOtransfer(false, index, subindex, size, data);
+}
+
+int EAL580B::_SDOwrite(uint16_t index, uint8_t subindex, int size, const void* data)
+{
+    return _SDOtransfer(true, index, subindex, &size, const_cast<void*>(data));
+}
+
+int EAL580B::_SDOtransfer(bool write, uint16_t index, uint8_t subindex, int* size, void* data)
+{
+    bool probe = false;
+    uint8_t sdoClass = _sdoClass(index);
+    uint32_t timeoutUs;
+
+    {
+        std::lock_guard<std::mutex> guard(_sdoMutex);
+
+        if(_sdoBreakerOpenNs != 0)
+        {
+            // Slave did not respond to the last transfers. Fail without mailbox traffic until probe time.
+            if(nowNs() - _sdoBreakerOpenNs < (uint64_t)parameters.SDO_BREAKER_OPEN_US * 1000)
+            {
+                _status = {EAL580B_ERR_SDO_BREAKER, subindex, index, 0, 0};
+                errorMessage = "Error Encoder EAL580B: SDO transfer was not started. Slave does not respond.";
+                return 0;
+            }
+
+            // One probe. Transfers of other threads fail at once until its result.
+            probe = true;
+            _sdoBreakerOpenNs = nowNs();
+        }
+
+        timeoutUs = _sdoTimeoutUs(sdoClass);
+    }
+
+    // A write without response may be executed. Preset and store/restore must not run twice, so they are not retried.
+    bool once = write && ( (index == Index_PresetValue) || (index == Index_SaveParameters) || (index == Index_RestoreParameters) );
+    int attempts = (probe || once) ? 1 : (1 + parameters.SDO_RETRIES);
+    int bufferSize = *size;
+    int wkc = 0;
+    uint32_t abortCode = 0;
+    uint32_t retries = 0;
+    uint32_t timeouts = 0;
+    uint64_t rttNs = 0;
+
+    // Non-blocking transfers and the failover of this slave use the same mailbox. Wait for the end of their transfer.
+    EAL580B_MailboxOwner mailbox;
+
+    if(!mailbox.acquire(parameters.ETHERCAT_ID, parameters.SDO_TIMEOUT_MAX_US))
+    {
+        _status = {EAL580B_ERR_MAILBOX_BUSY, subindex, index, 0, 0};
+        errorMessage = "Error Encoder EAL580B: SDO transfer was not started. Mailbox is used by another transfer.";
+        return 0;
+    }
+
+    for(int i = 0; i < attempts; i++)
+    {
+        if(i > 0)
+        {
+            retries++;
+            osal_usleep((uint32)(parameters.SDO_BACKOFF_US << ((i - 1 < 8) ? (i - 1) : 8)));
+            timeoutUs = (2 * (uint64_t)timeoutUs < parameters.SDO_TIMEOUT_MAX_US) ? (2 * timeoutUs) : parameters.SDO_TIMEOUT_MAX_US;
+            *size = bufferSize;
+        }
+
+        uint64_t startNs = nowNs();
+
+        if(write)
+        {
+            wkc = ec_SDOwrite(parameters.ETHERCAT_ID, index, subindex, FALSE, *size, data, (int)timeoutUs);
+        }
+        else
+        {
+            wkc = ec_SDOread(parameters.ETHERCAT_ID, index, subindex, FALSE, size, data, (int)timeoutUs);
+        }
+
+        rttNs = nowNs() - startNs;
+
+        abortCode = (wkc <= 0) ? _takeAbortCode(index, subindex) : 0;
+        metrics.addSdo(write, wkc, abortCode != 0, rttNs);
+
+        // Response and abort are round trip samples. SOEM empties the mailbox before each request,
+        // so a late response of a previous attempt is not measured.
+        if( (wkc > 0) || (abortCode != 0) )
+        {
+            break;
+        }
+
+        timeouts++;
+    }
+
+    mailbox.release();
+
+    {
+        std::lock_guard<std::mutex> guard(_sdoMutex);
+        SdoTimingStruct &timing = _sdoTiming[sdoClass];
+
+        timing.retries += retries;
+        timing.timeouts += timeouts;
+
+        if( (wkc > 0) || (abortCode != 0) )
+        {
+            _sdoAddSample(timing, (uint32_t)(rttNs / 1000));
+            _sdoFails = 0;
+            _sdoBreakerOpenNs = 0;
+        }
+        else
+        {
+            // Saturated. Breaker stays open while slave does not respond.
+            _sdoFails = (_sdoFails < UINT8_MAX) ? (_sdoFails + 1) : _sdoFails;
+
+            if( probe || ((parameters.SDO_BREAKER_FAILS != 0) && (_sdoFails >= parameters.SDO_BREAKER_FAILS)) )
+            {
+                _sdoBreakerOpenNs = nowNs();
+            }
+        }
+    }
+
+    if(wkc <= 0)
+    {
+        _setErrorSDO(write ? EAL580B_ERR_SDO_WRITE : EAL580B_ERR_SDO_READ, index, subindex, wkc, abortCode);
+        return wkc;
+    }
+
+    _status = {EAL580B_OK, subindex, index, wkc, 0};
+
+    return wkc;
+}
+
+uint8_t EAL580B::_sdoClass(uint16_t index)
+{
+    // Preset is stored in non-volatile memory too. It is slower than the position reads of the profile objects.
+    if( (index == Index_SaveParameters) || (index == Index_RestoreParameters) || (index == Index_PresetValue) )
+    {
+        return SDO_CLASS_STORE;
+    }
+
+    if(index < 0x2000)
+    {
+        return SDO_CLASS_COMMUNICATION;
+    }
+
+    return (index < 0x6000) ? SDO_CLASS_MANUFACTURER : SDO_CLASS_PROFILE;
+}
+
+void EAL580B::_sdoAddSample(SdoTimingStruct &timing, uint32_t rttUs)
+{
+    // Smoothed round trip time and variation with gains 1/8 and 1/4. (RFC 6298)
+    if(timing.samples == 0)
+    {
+        timing.srttUs = rttUs;
+        timing.rttvarUs = rttUs / 2;
+    }
+    else
+    {
+        int64_t error = (int64_t)rttUs - (int64_t)timing.srttUs;
+        int64_t deviation = (error < 0) ? -error : error;
+
+        timing.rttvarUs = (uint32_t)((int64_t)timing.rttvarUs + (deviation - (int64_t)timing.rttvarUs) / 4);
+        timing.srttUs = (uint32_t)((int64_t)timing.srttUs + error / 8);
+    }
+
+    timing.samples++;
+
+    uint64_t timeoutUs = (uint64_t)timing.srttUs + 4 * (uint64_t)timing.rttvarUs;
+
+    timeoutUs = (timeoutUs < parameters.SDO_TIMEOUT_MIN_US) ? parameters.SDO_TIMEOUT_MIN_US : timeoutUs;
+    timeoutUs = (timeoutUs > parameters.SDO_TIMEOUT_MAX_US) ? parameters.SDO_TIMEOUT_MAX_US : timeoutUs;
+
+    timing.timeoutUs = (uint32_t)timeoutUs;
+}
+
+EAL580B::SdoTimingStruct EAL580B::getSdoTiming(uint8_t sdoClass) const
+{
+    if(sdoClass >= SDO_CLASS_NUM)
+    {
+        return {0, 0, 0, 0, 0, 0};
+    }
+
+    std::lock_guard<std::mutex> guard(_sdoMutex);
+    SdoTimingStruct timing = _sdoTiming[sdoClass];
+    timing.timeoutUs = _sdoTimeoutUs(sdoClass);
+
+    return timing;
+}
+
+uint32_t EAL580B::_sdoTimeoutUs(uint8_t sdoClass) const
+{
+    if(_sdoTiming[sdoClass].samples == 0)
+    {
+        return (sdoClass == SDO_CLASS_STORE) ? parameters.SDO_TIMEOUT_MAX_US : parameters.SDO_TIMEOUT_INIT_US;
+    }
+
+    return _sdoTiming[sdoClass].timeoutUs;
+}
+
+bool EAL580B::isSdoBreakerOpen(void) const
+{
+    std::lock_guard<std::mutex> guard(_sdoMutex);
+
+    return _sdoBreakerOpenNs != 0;
+}
+
+void EAL580B::resetSdoTiming(void)
+{
+    std::lock_guard<std::mutex> guard(_sdoMutex);
+
+    for(uint8_t i = 0; i < SDO_CLASS_NUM; i++)
+    {
+        _sdoTiming[i] = {0, 0, 0, 0, 0, 0};
+    }
+
+    _sdoFails = 0;
+    _sdoBreakerOpenNs = 0;
+}
+
+uint32_t EAL580B::_takeAbortCode(uint16_t index, uint8_t subindex)
+{
+    uint32_t abortCode = 0;
+
+    // Take abort code of this transfer from the SOEM error list. Errors of other slaves are pushed back.
+    // The list is global. Transfers of other encoders in other threads must not pop and push at the same time.
+    std::lock_guard<std::mutex> guard(_errorListMutex);
+    ec_errort errorList[_ERROR_LIST_MAX];
+    int errorNum = 0;
+    ec_errort error;
+
+    while( (errorNum < _ERROR_LIST_MAX) && ec_iserror() && ec_poperror(&error) )
+    {
+        if( (error.Slave == parameters.ETHERCAT_ID) && (error.Etype == EC_ERR_TYPE_SDO_ERROR) &&
+            (error.Index == index) && (error.SubIdx == subindex) )
+        {
+            abortCode = (uint32_t)error.AbortCode;
+        }
+        else
+        {
+            errorList[errorNum++] = error;
         }
+    }
+
+    for(int i = 0; i < errorNum; i++)
+    {
+        ec_pusherror(&errorList[i]);
+    }
+
+    return abortCode;
+}
+
+void EAL580B::_setErrorSDO(uint8_t code, uint16_t index, uint8_t subindex, int wkc, uint32_t abortCode)
+{
+    if(abortCode != 0)
+    {
+        code = EAL580B_ERR_SDO_ABORT;
+    }
+
+    if(code == EAL580B_ERR_SDO_WRITE)
+    {
+        _recordError({code, subindex, index, wkc, abortCode}, "Error Encoder EAL580B: SDO write was not successed.");
+    }
+    else if(code == EAL580B_ERR_SDO_READ)
+    {
+        _recordError({code, subindex, index, wkc, abortCode}, "Error Encoder EAL580B: SDO read was not successed.");
+    }
+    else
+    {
+        _recordError({code, subindex, index, wkc, abortCode}, "Error Encoder EAL580B: SDO transfer aborted by slave.");
+    }
+}
+
+void EAL580B::_setError(uint8_t code, const char* message)
+{
+    _recordError({code, 0, 0, 0, 0}, message);
+}
+
+void EAL580B::_recordError(const EAL580B_Status &status, const char* message)
+{
+    _status = status;
+    errorMessage = message;
+
+    errors.push({EAL580B_ErrorRing::nowNs(), parameters.ETHERCAT_ID, _status, errorMessage});
+}
+
+uint8* EAL580B::_getInputs(void)
+{
+    if(_inputs != nullptr)
+    {
+        return _inputs;
+    }
+
+    return ec_slave[parameters.ETHERCAT_ID].inputs;
+}
+
+bool EAL580B::saveParamsAll(void)
+{
+    EAL580B_Status status;
+    uint32_t data = SAVE;
+    status = writeObject<EAL580B_OD::SaveParameters>(data);
+    
+    osal_usleep(1500000);
+    
+    if(!status.ok())
+        return FALSE;
+
+    return TRUE;
+}
+
+bool EAL580B::loadParamsAll(void)
+{
+    EAL580B_Status status;
+    uint32_t data = LOAD;
+    status = writeObject<EAL580B_OD::RestoreParameters>(data);
+    
+    osal_usleep(1500000);
+
+    if(!status.ok())
+        return FALSE;
+
+    return TRUE;
+}
+
+uint16_t EAL580B::getPositionValue2BytesSDO(void)
+{
+    uint16_t data = 0;
+    getPositionValue2BytesSDO(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getPositionValue2BytesSDO(uint16_t* data)
+{
+    return readObject<EAL580B_OD::PositionValue2Bytes>(data);
+}
+
+uint32_t EAL580B::getSystemTimePDO(void)
+{
+    if(_TxMapFlag[0] == 0)
+    {
+        return 0;
+    }
+
+    // Access the process data inputs for the specified slave
+    uint8 *inputs = _getInputs();
+    
+    uint32_t data = *(uint32_t *)(inputs + _TxMapOffset_SystemTime);
+
+    return data;
+}
+
+uint16_t EAL580B::getPositionValue2BytesPDO(void)
+{
+    if(_TxMapFlag[1] == 0)
+    {
+        return 0;
+    }
+
+    // Access the process data inputs for the specified slave
+    uint8 *inputs = _getInputs();
+    
+    // Write the torque to the specified offset
+    uint16_t data = *(uint16_t *)(inputs + _TxMapOffset_PositionValue2Bytes);
+
+    return data;
+}
+
+EAL580B_Status EAL580B::getPositionValue2BytesPDO(uint16_t* data)
+{
+    if(_TxMapFlag[1] == 0)
+    {
+        return {EAL580B_ERR_PDO_NOT_MAPPED, 0, 0, 0, 0};
+    }
+
+    *data = getPositionValue2BytesPDO();
+
+    return {EAL580B_OK, 0, 0, 0, 0};
+}
+
+int32_t EAL580B::getSpeedValue4BytesSDO(void)
+{
+    int32_t data = 0;
+    getSpeedValue4BytesSDO(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getSpeedValue4BytesSDO(int32_t* data)
+{
+    return readObject<EAL580B_OD::SpeedValue4Bytes>(data);
+}
+
+int32_t EAL580B::getSpeedValue4BytesPDO(void)
+{
+    if(_TxMapFlag[2] == 0)
+    {
+        return 0;
+    }
+    // Access the process data inputs for the specified slave
+    uint8 *inputs = _getInputs();
+    
+    // Write the torque to the specified offset
+    int32_t data = *(int32_t *)(inputs + _TxMapOffset_SpeedValue4Bytes);
+
+    return data;
+}
+
+EAL580B_Status EAL580B::getSpeedValue4BytesPDO(int32_t* data)
+{
+    if(_TxMapFlag[2] == 0)
+    {
+        return {EAL580B_ERR_PDO_NOT_MAPPED, 0, 0, 0, 0};
+    }
+
+    *data = getSpeedValue4BytesPDO();
+
+    return {EAL580B_OK, 0, 0, 0, 0};
+}
+
+bool EAL580B::setSpeedMeasuringUnit(uint8_t unit_num)
+{
+    EAL580B_Status status;
+    status = writeObject<EAL580B_OD::SpeedMeasuringUnit>(unit_num);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder EAL580B: setSpeedMeasuringUnit() was not successed.";
+        return FALSE;
+    }
+        
+    return TRUE; 
+}
+
+int32_t EAL580B::getSensorTemperatureSDO(void)
+{
+    int32_t data = 0;
+    getSensorTemperatureSDO(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getSensorTemperatureSDO(int32_t* data)
+{
+    if(readObject<EAL580B_OD::SensorTemperature>(data).ok())
+    {
+        metrics.setTemperature(*data, nowNs());
+    }
+
+    return _status;
+}
+
+int32_t EAL580B::getSensorTemperaturePDO(void)
+{
+    if(_TxMapFlag[3] == 0)
+    {
+        return 0;
+    }
+
+    // Access the process data inputs for the specified slave
+    uint8 *inputs = _getInputs();
+    
+    // Write the torque to the specified offset
+    int32_t data = *(int32_t *)(inputs + _TxMapOffset_SensorTemperature);
+
+    metrics.setTemperature(data, nowNs());
+
+    return data;
+}
+
+EAL580B_Status EAL580B::getSensorTemperaturePDO(int32_t* data)
+{
+    if(_TxMapFlag[3] == 0)
+    {
+        return {EAL580B_ERR_PDO_NOT_MAPPED, 0, 0, 0, 0};
+    }
+
+    *data = getSensorTemperaturePDO();
+
+    return {EAL580B_OK, 0, 0, 0, 0};
+}
+
+uint32_t EAL580B::getPositionValueSDO(void)
+{
+    uint32_t data = 0;
+    getPositionValueSDO(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getPositionValueSDO(uint32_t* data)
+{
+    return readObject<EAL580B_OD::PositionValue>(data);
+}
+
+uint32_t EAL580B::getPositionValuePDO(void)
+{
+    if(_TxMapFlag[4] == 0)
+    {
+        return 0;
+    }
+
+    // Access the process data inputs for the specified slave
+    uint8 *inputs = _getInputs();
+    
+    // Write the torque to the specified offset
+    uint32_t data = *(uint32_t *)(inputs + _TxMapOffset_PositionValue);
+
+    return data;
+}
+
+EAL580B_Status EAL580B::getPositionValuePDO(uint32_t* data)
+{
+    if(_TxMapFlag[4] == 0)
+    {
+        return {EAL580B_ERR_PDO_NOT_MAPPED, 0, 0, 0, 0};
+    }
+
+    *data = getPositionValuePDO();
+
+    return {EAL580B_OK, 0, 0, 0, 0};
+}
+
+uint32_t EAL580B::getPositionRawValueSDO(void)
+{
+    uint32_t data = 0;
+    getPositionRawValueSDO(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getPositionRawValueSDO(uint32_t* data)
+{
+    return readObject<EAL580B_OD::PositionRawValue>(data);
+}
+
+uint32_t EAL580B::getPositionRawValuePDO(void)
+{
+    if(_TxMapFlag[5] == 0)
+    {
+        return 0;
+    }
+
+    // Access the process data inputs for the specified slave
+    uint8 *inputs = _getInputs();
     
+    // Write the torque to the specified offset
+    uint32_t data = *(uint32_t *)(inputs + _TxMapOffset_PositionRawValue);
+
+    return data;
+}
+
+EAL580B_Status EAL580B::getPositionRawValuePDO(uint32_t* data)
+{
+    if(_TxMapFlag[5] == 0)
+    {
+        return {EAL580B_ERR_PDO_NOT_MAPPED, 0, 0, 0, 0};
+    }
+
+    *data = getPositionRawValuePDO();
+
+    return {EAL580B_OK, 0, 0, 0, 0};
+}
+
+uint32_t EAL580B::getSingleTurnResolution(void)
+{
+    uint32_t data = 0;
+    getSingleTurnResolution(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getSingleTurnResolution(uint32_t* data)
+{
+    if(!readObject<EAL580B_OD::SingleTurnResolution>(data).ok())
+    {
+        errorMessage = "Error Encoder: getSingleTurnResolution() not successed.";
+    }
+
+    return _status;
+}
+
+uint32_t EAL580B::getTotalMeasuringRange(void)
+{
+    uint32_t data = 0;
+    getTotalMeasuringRange(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getTotalMeasuringRange(uint32_t* data)
+{
+    if(!readObject<EAL580B_OD::TotalMeasuringRange>(data).ok())
+    {
+        errorMessage = "Error Encoder: getTotalMeasuringRange() is not successed.";
+    }
+
+    return _status;
+}
+
+bool EAL580B::setTotalMeasuringRange(uint32_t range)
+{
+    EAL580B_Status status;
+    status = writeObject<EAL580B_OD::TotalMeasuringRange>(range);
+
+    if(!status.ok())
+        return FALSE;
+
+    return TRUE;
+}
+
+bool EAL580B::setGearFactorFunctionality(bool enable)
+{
+    EAL580B_Status status;
+    uint16_t data;
+
+    if(enable)
+    {
+        data = 1;
+    }
+    else
+    {
+        data = 0;
+    }
+
+    status = writeObject<EAL580B_OD::GearFactorEnable>(data);
+    osal_usleep(10000); // delay 10ms
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder: setGearFactorFunctionality() was not successed.";
+        return false;
+    }
+        
+    return true;
+}
+
+bool EAL580B::setGearFactorScale(uint32_t numerator, uint32_t denominator)
+{
+    EAL580B_Status status;
+
+    status = writeObject<EAL580B_OD::GearFactorNumerator>(numerator);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder: setGearFactorScale() was not successed.";
+        return false;
     }
+        
 
-    return true;
+    status = writeObject<EAL580B_OD::GearFactorDenominator>(denominator);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder: setGearFactorScale() was not successed.";
+        return false;
+    }
+
+    return TRUE;
 }
 
-void EAL580B::_updateValuesConversion(void)
+uint32_t EAL580B::getNumberOfDistinguishableRevolutions(void)
 {
-    value.pos2BytesDeg = 360.0 * (double)value.pos2BytesStep / (double)_oneRevolutionMaxSteps;
-    value.posDeg = 360.0 * ((double)value.posStep - (double)_virtualOffset) / (double)_oneRevolutionMaxSteps;
-    value.posRawDeg = 360.0 * (double)value.posRawStep / (double)_oneRevolutionMaxSteps;
-    value.velDegSec = _velConStep2DegSec * (double)value.velStep;
+    uint32_t data = 0;
+    getNumberOfDistinguishableRevolutions(&data);
+    return data;
+}
 
-    if(parameters.GEAR_RATIO > 0)
+EAL580B_Status EAL580B::getNumberOfDistinguishableRevolutions(uint32_t* data)
+{
+    return readObject<EAL580B_OD::NumberOfDistinguishableRevolutions>(data);
+}
+
+int32_t EAL580B::getOffsetValue(void)
+{
+    int32_t data = 0;
+    getOffsetValue(&data);
+    return data;
+}
+
+EAL580B_Status EAL580B::getOffsetValue(int32_t* data)
+{
+    return readObject<EAL580B_OD::OffsetValue>(data);
+}
+
+bool EAL580B::setRotationDirection(uint8_t dir)
+{
+    EAL580B_Status status;
+    uint16_t data;
+    status = readObject<EAL580B_OD::OperatingParameters>(&data);
+
+    if(!status.ok())
     {
-        value.posDeg =  (double)parameters.GEAR_RATIO * value.posDeg;
-        value.velDegSec = (double)parameters.GEAR_RATIO * value.velDegSec;
+        errorMessage = "Error Encoder EAL580B: setRotationDirection() was not successed.";
+        return FALSE;
+    }
+        
+    if(dir == 1)
+        data |= (1 << 0);
+    else if(dir == 0)
+        data &= ~(1 << 0);
+    else 
+    {
+        _setError(EAL580B_ERR_PARAMETER, "Error Encoder EAL580B: setRotationDirection() was not successed.");
+        return FALSE;
+    }
+
+    status = writeObject<EAL580B_OD::OperatingParameters>(data);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder EAL580B: setRotationDirection() was not successed.";
+        return FALSE;
     }
+
+    return TRUE;
 }
 
-bool EAL580B::saveParamsAll(void)
+bool EAL580B::setScalingFunctionControl(bool enable)
 {
-    int wkc;
-    uint32_t data = SAVE;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_SaveParameters, 1, FALSE, 4, &data, EC_TIMEOUTRXM);
-    
-    osal_usleep(1500000);
-    
-    if(wkc <= 0)
+    EAL580B_Status status;
+    uint16_t data;
+    status = readObject<EAL580B_OD::OperatingParameters>(&data);
+
+    if(!status.ok())
+        return FALSE;
+        
+    if(enable)
+        data |= (1 << 2);
+    else
+        data &= ~(1 << 2);
+
+    status = writeObject<EAL580B_OD::OperatingParameters>(data);
+
+    if(!status.ok())
         return FALSE;
 
     return TRUE;
 }
 
-bool EAL580B::loadParamsAll(void)
+bool EAL580B::setPresetValueStep(uint32_t value)
 {
-    int wkc;
-    uint32_t data = LOAD;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_RestoreParameters, 1, FALSE, 4, &data, EC_TIMEOUTRXM);
-    
-    osal_usleep(1500000);
+    EAL580B_Status status;
 
-    if(wkc <= 0)
+    // Preset jump is not a glitch. Device can jump before the response, so detection is off during the transfer.
+    _presetBusy.fetch_add(1, std::memory_order_acq_rel);
+    status = writeObject<EAL580B_OD::PresetValue>(value);
+    _presetBusy.fetch_sub(1, std::memory_order_acq_rel);
+    _glitchReset.store(true, std::memory_order_release);
+
+    if(!status.ok())
+    {
+        errorMessage = "Error Encoder EAL580B: setPresetValueStep() was not successed."; 
         return FALSE;
+    }
 
     return TRUE;
 }
 
-uint16_t EAL580B::getPositionValue2BytesSDO(void)
+bool EAL580B::setPresetValueDeg(float value)
 {
-    int wkc;
-    int size = 2;
-    uint16_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_PositionValue2Bytes, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    double valueStep;
 
-    if(wkc <= 0)
-        return 0;
-        
-    return data;
+    valueStep = (double)_oneRevolutionMaxSteps * (double)value / 360.0;
+
+    if(parameters.GEAR_RATIO > 0)
+    {
+        valueStep /= parameters.GEAR_RATIO;
+    }
+
+    valueStep += _virtualOffset;
+
+    if(!setPresetValueStep((uint32_t)valueStep))
+    {
+        return false;
+    }
+
+    return true;
 }
 
-uint16_t EAL580B::getPositionValue2BytesPDO(void)
+void EAL580B::setSoftPresetDeg(double value)
 {
-    if(_TxMapFlag[1] == 0)
+    double valueStep = (double)_oneRevolutionMaxSteps * value / 360.0;
+
+    if(parameters.GEAR_RATIO > 0)
     {
-        return 0;
+        valueStep /= parameters.GEAR_RATIO;
     }
 
-    // Access the process data inputs for the specified slave
-    uint8 *inputs = ec_slave[parameters.ETHERCAT_ID].inputs;
-    
-    // Write the torque to the specified offset
-    uint16_t data = *(uint16_t *)(inputs + _TxMapOffset_PositionValue2Bytes);
+    // posStep - virtualOffset - offset = valueStep
+    double offset = (double)_lastPosStep.load(std::memory_order_relaxed) - (double)_virtualOffset - valueStep;
 
-    return data;
+    setSoftPresetStep((int64_t)llround(offset));
 }
 
-int32_t EAL580B::getSpeedValue4BytesSDO(void)
+bool EAL580B::commitSoftPreset(void)
 {
-    int wkc;
-    int size = 4;
-    int32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_SpeedValue4Bytes, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    int64_t offset = getSoftPresetStep();
 
-    if(wkc <= 0)
-        return FALSE;
+    if(offset == 0)
+    {
+        return true;
+    }
 
-    return data;
+    if(_presetExpect.load(std::memory_order_acquire) != 0)
+    {
+        errorMessage = "Error Encoder EAL580B: commitSoftPreset() was not successed. Last commit is pending.";
+        return false;
+    }
+
+    // Device position after preset must be the current soft preset position.
+    int64_t last = _lastPosStep.load(std::memory_order_relaxed);
+    int64_t target = last - offset;
+    int64_t range = _totalMeasuringMaxRange;
+
+    if(range > 0)
+    {
+        target = ((target % range) + range) % range;
+    }
+
+    // Host position is not unwrapped. So the offset takes the raw step change of the device.
+    int64_t expect = target - last;
+
+    if(_wrapStep(expect) == 0)
+    {
+        // Offset is a multiple of the measuring range. Device can not represent it, it stays host-side.
+        return true;
+    }
+
+    // Publish before the write. Device can jump before its response arrives.
+    _presetWritten.store(_PRESET_IN_FLIGHT, std::memory_order_relaxed);
+    _presetExpect.store(expect, std::memory_order_release);
+
+    bool ok = setPresetValueStep((uint32_t)target);
+
+    // Decode thread moves the offset at the device jump. Result decides only if no jump shows up.
+    _presetWritten.store(ok ? _PRESET_WRITTEN : _PRESET_FAILED, std::memory_order_release);
+
+    return ok;
 }
 
-int32_t EAL580B::getSpeedValue4BytesPDO(void)
+EAL580B* EAL580B::_recoveryRegistry[EC_MAXSLAVE] = {nullptr};
+
+std::mutex EAL580B::_errorListMutex;
+
+bool EAL580B::_readIdentity(_IdentityStruct &identity)
 {
-    if(_TxMapFlag[2] == 0)
+    if(!readObjects<EAL580B_OD::VendorId, EAL580B_OD::ProductCode, EAL580B_OD::SerialNumber>(
+            &identity.vendorId, &identity.productCode, &identity.serialNumber).ok())
+    {
+        errorMessage = "Error Encoder EAL580B: Identity object can not be read.";
+        return false;
+    }
+
+    return true;
+}
+
+int EAL580B::_PO2SOrecovery(uint16 slave)
+{
+    EAL580B *encoder = _recoveryRegistry[slave];
+
+    if(encoder == nullptr)
     {
         return 0;
     }
-    // Access the process data inputs for the specified slave
-    uint8 *inputs = ec_slave[parameters.ETHERCAT_ID].inputs;
-    
-    // Write the torque to the specified offset
-    int32_t data = *(int32_t *)(inputs + _TxMapOffset_SpeedValue4Bytes);
 
-    return data;
+    // SOEM ignores the return value and goes on to SAFE_OP. recover() checks the flag.
+    encoder->_reconfigFailed = !encoder->_reapplyConfig();
+
+    return encoder->_reconfigFailed ? 0 : 1;
+}
+
+bool EAL580B::_reapplyConfig(void)
+{
+    _IdentityStruct identity;
+
+    // Slave is back. Transfers of the reconfiguration must not be blocked by the breaker of the loss.
+    {
+        std::lock_guard<std::mutex> guard(_sdoMutex);
+        _sdoFails = 0;
+        _sdoBreakerOpenNs = 0;
+    }
+
+    if(!_readIdentity(identity))
+    {
+        return false;
+    }
+
+    if( (identity.vendorId != _identity.vendorId) || (identity.productCode != _identity.productCode) ||
+        (identity.serialNumber != _identity.serialNumber) )
+    {
+        _recoveryFailed = true;
+        recoveryCounter.failed++;
+        _setError(EAL580B_ERR_IDENTITY, "Error Encoder EAL580B: recover() was not successed. Slave identity is different.");
+        return false;
+    }
+
+    if( !setRotationDirection(parameters.ROTATION_DIR) || !setSpeedMeasuringUnit(parameters.SPD_UNIT) )
+    {
+        return false;
+    }
+
+    if(_syncMode != SYNC_MODE_FREE_RUN)
+    {
+        uint16_t type = _syncMode;
+
+        if( !writeObject<EAL580B_OD::SyncType>(type).ok() ||
+            ((_syncMode == SYNC_MODE_SM3) && !writeObject<EAL580B_OD::SpeedCalculationCycleTime>(_syncCycleNs / 1000).ok()) )
+        {
+            errorMessage = "Error Encoder EAL580B: recover() was not successed. Sync mode can not be written.";
+            return false;
+        }
+    }
+
+    // Cached TxPDO assignment. No waiting between writes. Mapping is verified in init().
+    if( !writeObject<EAL580B_OD::SyncManager3PDOAssignmentNum>((uint8_t)0).ok() ||
+        !writeObject<EAL580B_OD::SyncManager3PDOAssignment>((uint16_t)(Index_TPDOmapping_1 + _TxPDO_rank - 1)).ok() ||
+        !writeObject<EAL580B_OD::SyncManager3PDOAssignmentNum>((uint8_t)1).ok() )
+    {
+        errorMessage = "Error Encoder EAL580B: recover() was not successed. TxPDO assignment can not be written.";
+        return false;
+    }
+
+    // DC registers are lost after power loss.
+    _applySyncMode(_syncMode, _syncCycleNs, _syncShiftNs);
+
+    return true;
+}
+
+uint8_t EAL580B::recover(void)
+{
+    uint16_t id = parameters.ETHERCAT_ID;
+    ec_slavet &slave = ec_slave[id];
+    bool inOP = (slave.state == EC_STATE_OPERATIONAL) && !slave.islost;
+
+    if(_recoveryFailed)
+    {
+        // Another device is connected. No state requests until resetRecovery().
+        return RECOVERY_FAILED;
+    }
+
+    if(!_recovering)
+    {
+        if(inOP)
+        {
+            return RECOVERY_IDLE;
+        }
+
+        _recovering = true;
+        _reconfigFailed = false;
+        _recoveryStartNs = nowNs();
+
+        // Hook is set only during recovery. So ethercat configMap() never calls it.
+        _recoveryRegistry[id] = this;
+        slave.PO2SOconfig = &EAL580B::_PO2SOrecovery;
+    }
+
+    if(inOP)
+    {
+        uint64_t timeNs = nowNs() - _recoveryStartNs;
+
+        recoveryCounter.count++;
+        recoveryCounter.lastTimeNs = timeNs;
+        recoveryCounter.maxTimeNs = (timeNs > recoveryCounter.maxTimeNs) ? timeNs : recoveryCounter.maxTimeNs;
+
+        slave.PO2SOconfig = nullptr;
+        _recoveryRegistry[id] = nullptr;
+        _recovering = false;
+
+        // Prediction of glitch detection is not valid over the gap.
+        _glitchReset.store(true, std::memory_order_release);
+
+        return RECOVERY_DONE;
+    }
+
+    // Same steps as the SOEM slave check loop. Each step is one state request.
+    if(slave.state == (EC_STATE_SAFE_OP + EC_STATE_ERROR))
+    {
+        slave.state = (EC_STATE_SAFE_OP + EC_STATE_ACK);
+        ec_writestate(id);
+    }
+    else if((slave.state == EC_STATE_SAFE_OP) && _reconfigFailed)
+    {
+        // Configuration was not reapplied. Back to INIT, so the next step reconfigures again.
+        slave.state = EC_STATE_INIT;
+        ec_writestate(id);
+    }
+    else if(slave.state == EC_STATE_SAFE_OP)
+    {
+        slave.state = EC_STATE_OPERATIONAL;
+        ec_writestate(id);
+    }
+    else if(slave.state > EC_STATE_NONE)
+    {
+        // Reconfiguration calls _PO2SOrecovery() in PRE_OP.
+        _reconfigFailed = false;
+
+        if(ec_reconfig_slave(id, EC_TIMEOUTMON))
+        {
+            slave.islost = FALSE;
+        }
+
+        if(_reconfigFailed)
+        {
+            // Slave is in SAFE_OP without the cached configuration.
+            slave.state = EC_STATE_INIT;
+            ec_writestate(id);
+        }
+    }
+    else if(!slave.islost)
+    {
+        ec_statecheck(id, EC_STATE_OPERATIONAL, EC_TIMEOUTRET);
+
+        if(slave.state == EC_STATE_NONE)
+        {
+            slave.islost = TRUE;
+        }
+    }
+
+    if(slave.islost)
+    {
+        if(slave.state == EC_STATE_NONE)
+        {
+            if(ec_recover_slave(id, EC_TIMEOUTMON))
+            {
+                slave.islost = FALSE;
+            }
+        }
+        else
+        {
+            slave.islost = FALSE;
+        }
+    }
+
+    if(_recoveryFailed)
+    {
+        // Another device must not run with the configuration of this one. Hook is not needed until resetRecovery().
+        slave.state = EC_STATE_INIT;
+        ec_writestate(id);
+
+        slave.PO2SOconfig = nullptr;
+        _recoveryRegistry[id] = nullptr;
+        _recovering = false;
+
+        return RECOVERY_FAILED;
+    }
+
+    return RECOVERY_BUSY;
+}
+
+void EAL580B::resetRecovery(void)
+{
+    _recoveryFailed = false;
+}
+
+void EAL580B::updateValuesPDO(void)
+{
+    updateValuesPDO(-1);
+}
+
+void EAL580B::updateValuesPDO(int wkc)
+{
+    _sampleState = ec_slave[parameters.ETHERCAT_ID].state;
+    _sampleLost = ec_slave[parameters.ETHERCAT_ID].islost;
+    _sampleTimeNs = 0;
+    value.cycle = 0;
+
+    _decodePDO(wkc);
 }
 
-bool EAL580B::setSpeedMeasuringUnit(uint8_t unit_num)
+bool EAL580B::captureInputs(uint64_t cycle, int wkc)
 {
-    int wkc;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_SpeedCalculationConfiguration, 2, FALSE, 1, &unit_num, EC_TIMEOUTRXM);
+    const ec_slavet &slave = ec_slave[parameters.ETHERCAT_ID];
+    const uint8 *inputs = (_replay != nullptr) ? _replay->getInputs() : slave.inputs;
+    uint32_t size = (_replay != nullptr) ? _replay->getInputSize() : slave.Ibytes;
 
-    if(wkc <= 0)
+    if( (inputs == nullptr) || (size > SNAPSHOT_BYTES_MAX) )
     {
-        errorMessage = "Error Encoder EAL580B: setSpeedMeasuringUnit() was not successed.";
-        return FALSE;
+        return false;
     }
-        
-    return TRUE; 
-}
 
-int32_t EAL580B::getSensorTemperatureSDO(void)
-{
-    int wkc;
-    int size = 4;
-    int32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_SensorTemperature, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    // Single writer. Count is just loaded and stored.
+    uint64_t n = _snapshotCount.load(std::memory_order_relaxed);
+    _SnapshotSlotStruct &slot = _snapshots[n & 1];
 
-    if(wkc <= 0)
-        return FALSE;
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
 
-    return data;
+    slot.snapshot.cycle = cycle;
+    slot.snapshot.timeNs = nowNs();
+    slot.snapshot.wkc = wkc;
+    slot.snapshot.slaveState = slave.state;
+    slot.snapshot.slaveLost = slave.islost ? 1 : 0;
+    slot.snapshot.size = (uint8_t)size;
+    memcpy(slot.snapshot.inputs, inputs, size);
+
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    _snapshotCount.store(n + 1, std::memory_order_release);
+
+    return true;
 }
 
-int32_t EAL580B::getSensorTemperaturePDO(void)
+bool EAL580B::readSnapshot(InputSnapshotStruct &snapshot) const
 {
-    if(_TxMapFlag[3] == 0)
+    // Writer must capture two more times during one copy to overwrite it. A few retries are enough.
+    for(int i = 0; i < 4; i++)
     {
-        return 0;
-    }
+        uint64_t n = _snapshotCount.load(std::memory_order_acquire);
 
-    // Access the process data inputs for the specified slave
-    uint8 *inputs = ec_slave[parameters.ETHERCAT_ID].inputs;
-    
-    // Write the torque to the specified offset
-    int32_t data = *(int32_t *)(inputs + _TxMapOffset_SensorTemperature);
+        if(n == 0)
+        {
+            return false;
+        }
 
-    return data;
-}
+        const _SnapshotSlotStruct &slot = _snapshots[(n - 1) & 1];
 
-uint32_t EAL580B::getPositionValueSDO(void)
-{
-    int wkc;
-    int size = 4;
-    uint32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_PositionValue, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        snapshot = slot.snapshot;
+        std::atomic_thread_fence(std::memory_order_acquire);
 
-    if(wkc <= 0)
-        return 0;
+        if( (seq == 2 * n) && (slot.seq.load(std::memory_order_relaxed) == seq) )
+        {
+            return true;
+        }
+    }
 
-    return data;
+    return false;
 }
 
-uint32_t EAL580B::getPositionValuePDO(void)
+bool EAL580B::updateValuesSnapshot(void)
 {
-    if(_TxMapFlag[4] == 0)
+    uint64_t lastCycle = _decodeSnapshot.cycle;
+    uint64_t lastTimeNs = _decodeSnapshot.timeNs;
+
+    if(!readSnapshot(_decodeSnapshot))
     {
-        return 0;
+        return false;
     }
 
-    // Access the process data inputs for the specified slave
-    uint8 *inputs = ec_slave[parameters.ETHERCAT_ID].inputs;
-    
-    // Write the torque to the specified offset
-    uint32_t data = *(uint32_t *)(inputs + _TxMapOffset_PositionValue);
+    if( (_decodeSnapshot.cycle == lastCycle) && (_decodeSnapshot.timeNs == lastTimeNs) )
+    {
+        return false;
+    }
 
-    return data;
-}
+    // Snapshot inputs only for this decode. Live or replay inputs stay for later getters and updateValuesPDO().
+    uint8 *inputs = _inputs;
 
-uint32_t EAL580B::getPositionRawValueSDO(void)
-{
-    int wkc;
-    int size = 4;
-    uint32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_PositionRawValue, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    _inputs = _decodeSnapshot.inputs;
+    _sampleState = _decodeSnapshot.slaveState;
+    _sampleLost = (_decodeSnapshot.slaveLost != 0);
+    _sampleTimeNs = _decodeSnapshot.timeNs;
+    value.cycle = _decodeSnapshot.cycle;
 
-    if(wkc <= 0)
-        return 0;
+    _decodePDO(_decodeSnapshot.wkc);
 
-    return data;
+    _inputs = inputs;
+
+    return true;
 }
 
-uint32_t EAL580B::getPositionRawValuePDO(void)
+void EAL580B::_decodePDO(int wkc)
 {
-    if(_TxMapFlag[5] == 0)
+    value.pos2BytesStep = getPositionValue2BytesPDO();
+    value.posStep = getPositionValuePDO();
+    value.posRawStep = getPositionRawValuePDO();
+    value.velStep = getSpeedValue4BytesPDO();
+    _consumeGlitchReset();
+    _validateSample(wkc);
+    _trackPreset(value.status == SAMPLE_VALID);
+    bool pdo = (_failover == nullptr) || _applyFailover();
+    _updateValuesConversion();
+
+    // Held sample has no new sample instant. Timing and velocity estimation keep the last one.
+    if((value.status & SAMPLE_HELD) == 0)
     {
-        return 0;
+        _updateValuesTiming(pdo);
     }
 
-    // Access the process data inputs for the specified slave
-    uint8 *inputs = ec_slave[parameters.ETHERCAT_ID].inputs;
-    
-    // Write the torque to the specified offset
-    uint32_t data = *(uint32_t *)(inputs + _TxMapOffset_PositionRawValue);
-
-    return data;
+    _updateValuesConsumers();
 }
 
-uint32_t EAL580B::getSingleTurnResolution(void)
+bool EAL580B::_applyFailover(void)
 {
-    int wkc;
-    int size = 4;
-    uint32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_SingleTurnResolution, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    // Only process data faults start polling. Glitch is a position fault and a mapping without position is a configuration.
+    bool valid = ((value.status & (SAMPLE_STALE_WKC | SAMPLE_NOT_OP | SAMPLE_FROZEN)) == 0);
 
-    if(wkc <= 0)
+    if(valid)
     {
-        errorMessage = "Error Encoder: getSingleTurnResolution() not successed.";
-        return 0;
+        if( _degraded && (++_failoverValidRun >= _failover->parameters.RECOVER_SAMPLES) )
+        {
+            _degraded = false;
+            _failover->_setActive(_failoverSlot, false);
+        }
+
+        _holdPosStep = value.posStep;
+        _holdPosRawStep = value.posRawStep;
+        _holdPos2BytesStep = value.pos2BytesStep;
+        _holdVelStep = value.velStep;
+        _holdTimeNs = (_sampleTimeNs != 0) ? _sampleTimeNs : nowNs();
+
+        return true;
     }
-        
-    return data;
-}
 
-uint32_t EAL580B::getTotalMeasuringRange(void)
-{
-    int wkc;
-    int size = 4;
-    uint32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_TotalMeasuringRange, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    _failoverValidRun = 0;
 
-    if(wkc <= 0)
+    if(!_degraded)
     {
-        errorMessage = "Error Encoder: getTotalMeasuringRange() is not successed.";
-        return 0;
+        _degraded = true;
+        _failover->_setActive(_failoverSlot, true);
     }
-        
-    return data;
-}
 
-bool EAL580B::setTotalMeasuringRange(uint32_t range)
-{
-    int wkc;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_TotalMeasuringRange, 0, FALSE, 4, &range, EC_TIMEOUTRXM);
+    EAL580B_Failover::_PolledStruct polled;
+    uint64_t now = nowNs();
 
-    if(wkc <= 0)
-        return FALSE;
+    // Only a polled sample after the held one is new. A polled sample is used once.
+    if( _failover->_read(_failoverSlot, polled) && (polled.timeNs > _holdTimeNs) &&
+        (now - polled.timeNs <= (uint64_t)_failover->parameters.MAX_AGE_US * 1000) )
+    {
+        _holdPosStep = polled.posStep;
+        _holdPosRawStep = polled.posRawStep;
+        _holdPos2BytesStep = polled.pos2BytesStep;
+        _holdVelStep = polled.velStep;
+        _holdTimeNs = polled.timeNs;
+        _sampleTimeNs = polled.timeNs;
+        value.status = SAMPLE_DEGRADED;
+    }
+    else
+    {
+        // No new polled sample. Hold last values and keep the reason flags.
+        value.status |= SAMPLE_DEGRADED | SAMPLE_HELD;
+    }
 
-    return TRUE;
+    value.posStep = _holdPosStep;
+    value.posRawStep = _holdPosRawStep;
+    value.pos2BytesStep = _holdPos2BytesStep;
+    value.velStep = _holdVelStep;
+    sampleCounter.degraded++;
+
+    return false;
 }
 
-bool EAL580B::setGearFactorFunctionality(bool enable)
+void EAL580B::_validateSample(int wkc)
 {
-    int wkc;
-    uint16_t data;
+    uint8_t status = SAMPLE_VALID;
 
-    if(enable)
+    if(_replay != nullptr)
     {
-        data = 1;
+        // Recorded sample status is in high byte of record status.
+        status = (uint8_t)(_replay->getRecord().status >> 8);
     }
     else
     {
-        data = 0;
-    }
+        ec_slavet &slave = ec_slave[parameters.ETHERCAT_ID];
 
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_GearFactorConfiguration, 1, FALSE, 2, &data, EC_TIMEOUTRXM);
-    osal_usleep(10000); // delay 10ms
+        if(wkc >= 0)
+        {
+            const ec_groupt &group = ec_group[slave.group];
+            int expectedWKC = (group.outputsWKC * 2) + group.inputsWKC;
 
-    if(wkc <= 0)
-    {
-        errorMessage = "Error Encoder: setGearFactorFunctionality() was not successed.";
-        return false;
+            if(wkc < expectedWKC)
+            {
+                status |= SAMPLE_STALE_WKC;
+                sampleCounter.missed++;
+                metrics.addPdoMissed();
+            }
+        }
+
+        if( ((_sampleState & 0x0F) != EC_STATE_OPERATIONAL) || _sampleLost )
+        {
+            status |= SAMPLE_NOT_OP;
+        }
     }
-        
-    return true;
-}
 
-bool EAL580B::setGearFactorScale(uint32_t numerator, uint32_t denominator)
-{
-    int wkc;
+    if(_TxMapFlag[0] != 0)
+    {
+        uint32_t systemTime = getSystemTimePDO();
+
+        if(systemTime == value.systemTime)
+        {
+            status |= SAMPLE_FROZEN;
+        }
 
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_GearFactorConfiguration, 2, FALSE, 4, &numerator, EC_TIMEOUTRXM);
+        value.systemTime = systemTime;
+    }
 
-    if(wkc <= 0)
+    if(parameters.GLITCH_MARGIN_STEP != 0)
     {
-        errorMessage = "Error Encoder: setGearFactorScale() was not successed.";
-        return false;
+        if( (status == SAMPLE_VALID) && (_TxMapFlag[4] != 0) )
+        {
+            status |= _checkGlitch();
+        }
+        else
+        {
+            // Prediction needs consecutive valid samples.
+            _glitchHistory = 0;
+        }
     }
-        
 
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_GearFactorConfiguration, 3, FALSE, 4, &denominator, EC_TIMEOUTRXM);
+    if(status == SAMPLE_VALID)
+    {
+        sampleCounter.valid++;
+
+        if(sampleCounter.invalidRun > 0)
+        {
+            sampleCounter.recovered++;
+        }
 
-    if(wkc <= 0)
+        sampleCounter.invalidRun = 0;
+    }
+    else
     {
-        errorMessage = "Error Encoder: setGearFactorScale() was not successed.";
-        return false;
+        sampleCounter.stale++;
+        sampleCounter.invalidRun++;
+        metrics.addPdoStale();
     }
 
-    return TRUE;
+    metrics.addPdoDecode();
+    value.status = status;
 }
 
-uint32_t EAL580B::getNumberOfDistinguishableRevolutions(void)
+int64_t EAL580B::_wrapStep(int64_t delta) const
 {
-    int wkc;
-    int size = 4;
-    uint32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_NumberOfDistinguishableRevolutions, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    int64_t range = _totalMeasuringMaxRange;
 
-    if(wkc <= 0)
-        return 0;
+    if(range > 0)
+    {
+        delta = (delta > range / 2) ? (delta - range) : ((delta < -range / 2) ? (delta + range) : delta);
+    }
 
-    return data;
+    return delta;
 }
 
-int32_t EAL580B::getOffsetValue(void)
+void EAL580B::_consumeGlitchReset(void)
 {
-    int wkc;
-    int size = 4;
-    int32_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_OffsetValue, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
-    
-    if(wkc <= 0)
-        return FALSE;
-    
-    return data;
+    if( (_presetBusy.load(std::memory_order_acquire) != 0) ||
+        (_glitchReset.load(std::memory_order_relaxed) && _glitchReset.exchange(false, std::memory_order_acq_rel)) )
+    {
+        // Device position can jump. No prediction or velocity over it.
+        _glitchHistory = 0;
+        _prevPosValid = false;
+    }
 }
 
-bool EAL580B::setRotationDirection(uint8_t dir)
+void EAL580B::_trackPreset(bool valid)
 {
-    int wkc;
-    int size = 2;
-    uint16_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_OperatingParameters, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
+    if(!valid)
+    {
+        // Not valid position is no reference. Motion is learned again after the gap.
+        _presetHistory = 0;
+        return;
+    }
 
-    if(wkc <= 0)
+    uint32_t pos = value.posStep;
+    int64_t delta = (_presetHistory > 0) ? _wrapStep((int64_t)pos - (int64_t)_presetPrevStep) : 0;
+    int64_t expect = _presetExpect.load(std::memory_order_acquire);
+
+    // Step change without the motion of one sample. Constant speed, like glitch prediction.
+    int64_t jump = delta - _presetPrevDelta;
+
+    if(expect == 0)
     {
-        errorMessage = "Error Encoder EAL580B: setRotationDirection() was not successed.";
-        return FALSE;
+        _presetWait = 0;
     }
-        
-    if(dir == 1)
-        data |= (1 << 0);
-    else if(dir == 0)
-        data &= ~(1 << 0);
-    else 
+    else if( (_presetHistory >= 2) && (2 * llabs(_wrapStep(jump - expect)) <= llabs(_wrapStep(expect))) )
     {
-        errorMessage = "Error Encoder EAL580B: setRotationDirection() was not successed.";
-        return FALSE;
+        // Device jump of commit shows up. Host-side offset takes the jump, so position stays continuous.
+        // A new soft preset during the transfer stays.
+        _softOffset.fetch_add(expect + _wrapStep(jump - expect), std::memory_order_acq_rel);
+        _presetExpect.store(0, std::memory_order_release);
+        _glitchHistory = 0;
+        _prevPosValid = false;
+        delta = _presetPrevDelta;
     }
-
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_OperatingParameters, 0, FALSE, 2, &data, EC_TIMEOUTRXM);
-
-    if(wkc <= 0)
+    else if( (_presetWritten.load(std::memory_order_acquire) != _PRESET_IN_FLIGHT) && (++_presetWait > _PRESET_WAIT_MAX) )
     {
-        errorMessage = "Error Encoder EAL580B: setRotationDirection() was not successed.";
-        return FALSE;
+        // Jump is hidden in motion or did not happen. Trust the write result.
+        if(_presetWritten.load(std::memory_order_relaxed) == _PRESET_WRITTEN)
+        {
+            _softOffset.fetch_add(expect, std::memory_order_acq_rel);
+        }
+
+        _presetExpect.store(0, std::memory_order_release);
     }
 
-    return TRUE;
+    _presetPrevStep = pos;
+    _presetPrevDelta = (_presetHistory > 0) ? delta : 0;
+    _presetHistory = (_presetHistory < 2) ? (_presetHistory + 1) : 2;
 }
 
-bool EAL580B::setScalingFunctionControl(bool enable)
+uint8_t EAL580B::_checkGlitch(void)
 {
-    int wkc;
-    int size = 2;
-    uint16_t data;
-    wkc = ec_SDOread(parameters.ETHERCAT_ID, Index_OperatingParameters, 0, FALSE, &size, &data, EC_TIMEOUTRXM);
-
-    if(wkc <= 0)
-        return FALSE;
-        
-    if(enable)
-        data |= (1 << 2);
-    else
-        data &= ~(1 << 2);
+    uint32_t pos = value.posStep;
+    int64_t range = _totalMeasuringMaxRange;
 
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_OperatingParameters, 0, FALSE, 2, &data, EC_TIMEOUTRXM);
+    // Step change with wrap at total measuring range.
+    int64_t delta = (int64_t)pos - (int64_t)_glitchPrevStep;
 
-    if(wkc <= 0)
-        return FALSE;
+    if(range > 0)
+    {
+        delta = (delta > range / 2) ? (delta - range) : ((delta < -range / 2) ? (delta + range) : delta);
+    }
 
-    return TRUE;
-}
+    if(_glitchHistory < 2)
+    {
+        _glitchPrevDelta = (_glitchHistory == 1) ? delta : 0;
+        _glitchPrevStep = pos;
+        _glitchHistory++;
+        return SAMPLE_VALID;
+    }
 
-bool EAL580B::setPresetValueStep(uint32_t value)
-{
-    int wkc;
-    wkc = ec_SDOwrite(parameters.ETHERCAT_ID, Index_PresetValue, 0, FALSE, 4, &value, EC_TIMEOUTRXM);
+    // Constant speed prediction: step change stays the same.
+    int64_t error = delta - _glitchPrevDelta;
 
-    if(wkc <= 0)
+    if( (error <= (int64_t)parameters.GLITCH_MARGIN_STEP) && (error >= -(int64_t)parameters.GLITCH_MARGIN_STEP) )
     {
-        errorMessage = "Error Encoder EAL580B: setPresetValueStep() was not successed."; 
-        return FALSE;
+        _glitchPrevDelta = delta;
+        _glitchPrevStep = pos;
+        _glitchRun = 0;
+        return SAMPLE_VALID;
     }
 
-    return TRUE;
-}
+    sampleCounter.glitches++;
 
-bool EAL580B::setPresetValueDeg(float value)
-{
-    double valueStep;
+    if(_glitchRun >= _GLITCH_RUN_MAX)
+    {
+        // Jump persists. Take new position as real and learn step change again.
+        _glitchPrevStep = pos;
+        _glitchHistory = 1;
+        _glitchRun = 0;
+        return SAMPLE_GLITCH;
+    }
 
-    valueStep = (double)_oneRevolutionMaxSteps * (double)value / 360.0;
+    // Glitch position is never a reference for next samples. Prediction goes on from previous accepted samples.
+    int64_t predicted = (int64_t)_glitchPrevStep + _glitchPrevDelta;
 
-    if(parameters.GEAR_RATIO > 0)
+    if(range > 0)
     {
-        valueStep /= parameters.GEAR_RATIO;
+        predicted = ((predicted % range) + range) % range;
     }
 
-    valueStep += _virtualOffset;
+    _glitchPrevStep = (uint32_t)predicted;
+    _glitchRun++;
 
-    if(!setPresetValueStep((uint32_t)valueStep))
+    if(parameters.GLITCH_REJECT)
     {
-        return false;
+        value.posStep = _glitchPrevStep;
+        sampleCounter.rejected++;
     }
 
-    return true;
-}
-
-void EAL580B::updateValuesPDO(void)
-{
-    value.pos2BytesStep = getPositionValue2BytesPDO();
-    value.posStep = getPositionValuePDO();
-    value.posRawStep = getPositionRawValuePDO();
-    value.velStep = getSpeedValue4BytesPDO();
-    _updateValuesConversion();
+    return SAMPLE_GLITCH;
 }
 
 void EAL580B::updateValuesSDO(void)
@@ -786,17 +2546,39 @@ void EAL580B::updateValuesSDO(void)
     value.posRawStep = getPositionRawValueSDO();
     value.velStep = getSpeedValue4BytesSDO();
 
+    _consumeGlitchReset();
+    _trackPreset(true);
     _updateValuesConversion();
+    _updateValuesTiming(false);
+    _updateValuesConsumers();
 }
 
+void EAL580B::attachRecorder(EAL580B_Recorder* recorder)
+{
+    _recorder = recorder;
+}
 
+void EAL580B::attachPublisher(EAL580B_ShmPublisher* publisher, uint16_t slot)
+{
+    _publisher = publisher;
+    _publisherSlot = slot;
+}
 
+void EAL580B::attachDecimator(EAL580B_Decimator* decimator, uint16_t slot)
+{
+    _decimator = decimator;
+    _decimatorSlot = slot;
+}
 
+void EAL580B::attachHistory(EAL580B_History* history)
+{
+    _history = history;
+}
 
-
-
-
-
-
-
-
+void EAL580B::attachFailover(EAL580B_Failover* failover, uint16_t slot)
+{
+    _failover = failover;
+    _failoverSlot = slot;
+    _degraded = false;
+    _failoverValidRun = 0;
+}
@@ -5,7 +5,13 @@
 #include <iostream>                 // standard I/O operations
 #include <chrono>                   // For time managements
 #include <thread>                   // For thread programming
+#include <mutex>                    // For SDO timing state and SOEM error list
 #include "ethercat.h"               // EtherCAT functionality 
+#include "EAL580B_PositionCompare.h"    // Position compare / electronic cam engine
+#include "EAL580B_Recorder.h"           // Memory-mapped binary sample recorder
+#include "EAL580B_Replay.h"             // Replay of recorded process data
+#include "EAL580B_Error.h"              // Error codes, status and error event ring
+#include "EAL580B_Metrics.h"            // Atomic SDO/PDO metrics
 
 using namespace std;
 
@@ -17,15 +23,77 @@ namespace EAL580B_Namespace
     #define SPD_UNIT_STEP_100MS             0x01
     #define SPD_UNIT_STEP_10MS              0x02
     #define SPD_UNIT_RPM                    0x03
+
+    // Sample status flags of ValueStruct::status. 0 means valid sample.
+    #define SAMPLE_VALID                    0x00
+    #define SAMPLE_STALE_WKC                0x01        // Working counter lower than expected. Frame lost or slave did not process it.
+    #define SAMPLE_NOT_OP                   0x02        // Slave is not in OP state or is lost.
+    #define SAMPLE_FROZEN                   0x04        // Mapped SystemTime did not advance since previous sample.
+    #define SAMPLE_GLITCH                   0x08        // Position step is out of the bound predicted from previous samples.
+    #define SAMPLE_DEGRADED                 0x10        // Process data is not valid. Position and speed are from SDO polling or held.
+    #define SAMPLE_HELD                     0x20        // Degraded sample repeats the last known values. No new sample instant.
+
+    // Process data signals for ParameterStruct::PDO_SIGNALS:
+    #define PDO_SIGNAL_SYSTEM_TIME          0x01        // Object 0x2000
+    #define PDO_SIGNAL_POSITION_2BYTES      0x02        // Object 0x2003
+    #define PDO_SIGNAL_SPEED                0x04        // Object 0x2004
+    #define PDO_SIGNAL_TEMPERATURE          0x08        // Object 0x2120
+    #define PDO_SIGNAL_POSITION             0x10        // Object 0x6004
+    #define PDO_SIGNAL_POSITION_RAW         0x20        // Object 0x600C
+    #define PDO_SIGNAL_ALL                  0x3F
+
+    // Synchronization modes for ParameterStruct::SYNC_MODE. (Object 0x1C33:1 values)
+    #define SYNC_MODE_FREE_RUN              0x00        // Encoder samples at its own rhythm.
+    #define SYNC_MODE_SM3                   0x01        // Encoder samples at SM3 event. (input frame read)
+    #define SYNC_MODE_DC                    0x02        // Encoder samples at DC SYNC0 event.
+
+    // Results of EAL580B::recover():
+    #define RECOVERY_IDLE                   0           // Slave is in OP. Nothing to do.
+    #define RECOVERY_BUSY                   1           // Slave is being brought back to OP.
+    #define RECOVERY_DONE                   2           // Slave is back in OP. See recoveryCounter.lastTimeNs.
+    #define RECOVERY_FAILED                 3           // Identity check failed. Slave is not brought to OP until resetRecovery().
+
+    // SDO object classes with own round trip statistics and timeout:
+    #define SDO_CLASS_COMMUNICATION         0           // Objects 0x1000 - 0x1FFF
+    #define SDO_CLASS_MANUFACTURER          1           // Objects 0x2000 - 0x5FFF
+    #define SDO_CLASS_PROFILE               2           // Objects 0x6000 - 0xFFFF
+    #define SDO_CLASS_STORE                 3           // Objects 0x1010, 0x1011, 0x6003. (non-volatile memory access)
+    #define SDO_CLASS_NUM                   4
+
+    // Max input bytes of one encoder kept in an input snapshot.
+    #define SNAPSHOT_BYTES_MAX              32
 }
 
+// #################################################################################
+
+// Shared memory publisher. (EAL580B_SharedMemory.h)
+class EAL580B_ShmPublisher;
+
+// Decimating aggregation stage. (EAL580B_Decimator.h)
+class EAL580B_Decimator;
+
+// Time-indexed position history. (EAL580B_History.h)
+class EAL580B_History;
+
+// PDO to SDO failover. (EAL580B_Failover.h)
+class EAL580B_Failover;
+
+// Coroutine versions of configuration functions. (EAL580B_Async.h)
+class EAL580B_Async;
+
 // #################################################################################
 class EAL580B
 {
     public:
 
-        /// Last error accured for object.
-        std::string errorMessage;
+        /// Last error accured for object. It points to a static string, so setting it never allocates memory.
+        const char* errorMessage;
+
+        /// Recent error events of object. Lock-free, safe to read from any thread.
+        EAL580B_ErrorRing errors;
+
+        /// SDO and PDO metrics of encoder. Register in an EAL580B_MetricsRegistry for export.
+        EAL580B_Metrics metrics;
 
         struct ParameterStruct
         {
@@ -74,6 +142,13 @@ class EAL580B
              */
             uint8_t PDOMAP_CONFIG_TYPE;
 
+            /**
+             * @brief Required process data signals. Bitwise or of PDO_SIGNAL_xxx.
+             * @note The TxPDO rank with the fewest bytes that covers all signals is selected from the mapping read from device.
+             * @note Value 0 means not used. Then PDOMAP_CONFIG_TYPE selects the mapping. The default value is 0.
+             */
+            uint8_t PDO_SIGNALS;
+
             /**
              * @brief Direction behavior. 0: CW, 1:CCW     
              * @note - If dir be 0 the position value increases if the shaft is rotated clockwise (looking at the shaft). 
@@ -81,8 +156,106 @@ class EAL580B
              */
             uint8_t ROTATION_DIR;
 
+            /**
+             * @brief Fixed part of delay from position sampling in encoder until sample decode in host. [us]
+             * @note It is added to the learned delay for position extrapolation. The default value is 0.
+             */
+            uint32_t SAMPLE_DELAY_US;
+
+            /**
+             * @brief Synchronization mode of input sampling. SYNC_MODE_xxx. It is set in init().
+             * @note The default value is SYNC_MODE_FREE_RUN. Then init() does not change synchronization objects.
+             */
+            uint8_t SYNC_MODE;
+
+            /**
+             * @brief Process data cycle time of master. [ns] Needed if SYNC_MODE is not free run.
+             */
+            uint32_t SYNC_CYCLE_NS;
+
+            /**
+             * @brief Allowed difference of position step change from the step change of previous sample. [step]
+             * It bounds acceleration plus noise: about maxAcc[step/s^2] * period[s]^2 + 2 * noise[step].
+             * @note Value 0 disables glitch detection. The default value is 0. Needs PositionValue in TxPDO.
+             */
+            uint32_t GLITCH_MARGIN_STEP;
+
+            /**
+             * @brief true -> Replace glitch position with predicted position. false -> Only flag it with SAMPLE_GLITCH.
+             * @note After some consecutive glitches the new position is taken as real. (e.g. preset) The default value is false.
+             */
+            bool GLITCH_REJECT;
+
+            /**
+             * @brief SDO timeout of an object class without round trip samples. [us]
+             * @note The default value is 100000. SDO_CLASS_STORE uses SDO_TIMEOUT_MAX_US.
+             */
+            uint32_t SDO_TIMEOUT_INIT_US;
+
+            /**
+             * @brief Range of learned SDO timeout. (smoothed round trip time + 4 * round trip variation) [us]
+             * @note The default values are 2000 and EC_TIMEOUTRXM.
+             */
+            uint32_t SDO_TIMEOUT_MIN_US;
+            uint32_t SDO_TIMEOUT_MAX_US;
+
+            /**
+             * @brief Number of SDO retries after a transfer without response. Timeout doubles for each retry.
+             * @note Abort of slave is not retried. Writes of preset (0x6003) and store/restore (0x1010/0x1011) are not
+             * retried: a write without response may be executed, and they must not run twice. The default value is 2.
+             */
+            uint8_t SDO_RETRIES;
+
+            /**
+             * @brief Wait before first SDO retry. [us] It doubles for each retry. The default value is 1000.
+             */
+            uint32_t SDO_BACKOFF_US;
+
+            /**
+             * @brief Number of consecutive SDO transfers without response (after retries) that open the SDO breaker.
+             * Then SDO functions fail at once with EAL580B_ERR_SDO_BREAKER for SDO_BREAKER_OPEN_US.
+             * After that one transfer without retry probes the slave.
+             * @note Value 0 disables the breaker. The default value is 2.
+             */
+            uint8_t SDO_BREAKER_FAILS;
+
+            /**
+             * @brief Time of open SDO breaker until next probe. [us] The default value is 1000000.
+             */
+            uint32_t SDO_BREAKER_OPEN_US;
+
         }parameters;
 
+        /**
+         * @brief Synchronization state read from device. See getSyncReport().
+         */
+        struct SyncReportStruct
+        {
+            /// Synchronization type. (0x1C33:1)
+            uint16_t mode;
+
+            /// Cycle time. (0x1C33:2) [ns]
+            uint32_t cycleTimeNs;
+
+            /// Time from SYNC0 to input latch. (0x1C33:3) [ns]
+            uint32_t shiftTimeNs;
+
+            /// Time from input latch until inputs are ready for the frame. (0x1C33:6) [ns]
+            uint32_t calcCopyTimeNs;
+
+            /// Cycle time too small counter. (0x1C33:12)
+            uint16_t cycleTimeTooSmall;
+
+            /// Sync error flag. (0x1C33:32)
+            uint8_t syncError;
+
+            /**
+             * @brief Age of sampled position when the frame reads it. [ns]
+             * @note DC mode: from SYNC0 phase and DC time of last frame (ec_DCtime). SM3 mode: one cycle. Free run: -1. (unknown, up to one encoder cycle)
+             */
+            int64_t sampleOffsetNs;
+        };
+
         struct ValueStruct
         {
             uint16_t pos2BytesStep;
@@ -93,8 +266,134 @@ class EAL580B
             double posDeg;
             double posRawDeg;
             double velDegSec;
+
+            /// Filtered speed. [deg/s] Set by EAL580B_FilterBank::update(). Otherwise 0.
+            double velFiltDegSec;
+
+            /// Filtered acceleration derived from filtered speed. [deg/s^2] Set by EAL580B_FilterBank::update(). Otherwise 0.
+            double accDegSec2;
+
+            /// Sample status flags. SAMPLE_VALID (0) or combination of SAMPLE_STALE_WKC, SAMPLE_NOT_OP, SAMPLE_FROZEN, SAMPLE_GLITCH,
+            /// SAMPLE_DEGRADED, SAMPLE_HELD.
+            uint8_t status;
+
+            /// SystemTime of sample from encoder. Just if SystemTime is in TxPDO mapping.
+            uint32_t systemTime;
+
+            /// Host time of sample decode. [ns] Time base of nowNs(). Capture time for updateValuesSnapshot().
+            uint64_t timeNs;
+
+            /// Bus cycle of sample. Set by updateValuesSnapshot(). 0 for other update functions.
+            uint64_t cycle;
         }value;
 
+        /**
+         * @brief Copy of encoder process data inputs of one bus cycle.
+         */
+        struct InputSnapshotStruct
+        {
+            /// Bus cycle counter given to captureInputs().
+            uint64_t cycle;
+
+            /// Host time of capture. [ns] Time base of nowNs().
+            uint64_t timeNs;
+
+            /// Working counter of cycle. -1 if unknown.
+            int wkc;
+
+            /// Slave state at capture. (ec_slave[ID].state)
+            uint16_t slaveState;
+
+            /// 1 if slave was lost at capture.
+            uint8_t slaveLost;
+
+            /// Number of valid bytes in inputs.
+            uint8_t size;
+
+            uint8_t inputs[SNAPSHOT_BYTES_MAX];
+        };
+
+        /**
+         * @brief Sample validation counters. Updated by updateValuesPDO() in cyclic thread.
+         */
+        struct SampleCounterStruct
+        {
+            /// Number of valid samples.
+            uint64_t valid;
+
+            /// Number of samples with any status flag. (not fresh)
+            uint64_t stale;
+
+            /// Number of cycles with working counter lower than expected. (missed frames)
+            uint64_t missed;
+
+            /// Number of transitions from not valid to valid sample.
+            uint64_t recovered;
+
+            /// Number of consecutive not valid samples until now.
+            uint32_t invalidRun;
+
+            /// Number of samples flagged with SAMPLE_GLITCH.
+            uint64_t glitches;
+
+            /// Number of glitch samples replaced with predicted position.
+            uint64_t rejected;
+
+            /// Number of samples with SAMPLE_DEGRADED. (see attachFailover())
+            uint64_t degraded;
+        }sampleCounter;
+
+        /**
+         * @brief Hot reconnect counters. Updated by recover().
+         */
+        struct RecoveryCounterStruct
+        {
+            /// Number of finished recoveries.
+            uint32_t count;
+
+            /// Number of failed identity checks.
+            uint32_t failed;
+
+            /// Time from loss detection until OP of last recovery. [ns]
+            uint64_t lastTimeNs;
+
+            /// Max recovery time. [ns]
+            uint64_t maxTimeNs;
+        }recoveryCounter;
+
+        /**
+         * @brief SDO round trip statistic of one object class. See getSdoTiming().
+         */
+        struct SdoTimingStruct
+        {
+            /// Smoothed round trip time. [us]
+            uint32_t srttUs;
+
+            /// Round trip time variation. [us]
+            uint32_t rttvarUs;
+
+            /// Timeout of next transfer. [us]
+            uint32_t timeoutUs;
+
+            /// Number of round trip samples. (responses and aborts)
+            uint32_t samples;
+
+            /// Number of retries.
+            uint32_t retries;
+
+            /// Number of transfers without response.
+            uint32_t timeouts;
+        };
+
+        /**
+         * @brief Position compare engine. It is evaluated on value.posDeg at each updateValuesPDO() and updateValuesSDO().
+         * Samples with SAMPLE_STALE_WKC, SAMPLE_NOT_OP, SAMPLE_FROZEN, SAMPLE_GLITCH or SAMPLE_HELD are skipped and
+         * the next valid sample only latches its position.
+         * @note Add windows and triggers then call positionCompare.build() before cyclic updates.
+         * Set positionCompare.parameters.RANGE_DEG to the position range if position wraps.
+         */
+        EAL580B_PositionCompare positionCompare;
+
         /// @brief  Default constructor. Init parameters and values.
         EAL580B();
 
@@ -104,6 +403,17 @@ class EAL580B
          */
         bool init(void);
 
+        /**
+         * @brief Init object for replay mode. No ethercat communication.
+         * Process data inputs are taken from replay object instead of ec_slave[].inputs.
+         * @param replay is an opened replay object.
+         * @param singleTurnResolution is getSingleTurnResolution() value of the recorded encoder.
+         * @param totalMeasuringRange is getTotalMeasuringRange() value of the recorded encoder.
+         * @note parameters must be same as recording time. (PDOMAP_CONFIG_TYPE, SPD_UNIT, GEAR_RATIO)
+         * @return true if successed.
+         */
+        bool initReplay(EAL580B_Replay* replay, uint32_t singleTurnResolution, uint32_t totalMeasuringRange);
+
         /**
          * @brief Check parameters validation.
          * @return true if successed.
@@ -126,6 +436,46 @@ class EAL580B
          *  */ 
         uint16_t getTxPDO_rank(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getTxPDO_rank(uint16_t* data);
+
+        /**
+         * @brief Return signals decoded from the selected TxPDO. Bitwise or of PDO_SIGNAL_xxx.
+         */
+        uint8_t getMappedSignals(void) const;
+
+        /**
+         * @brief Check process data size of slave against the TxPDO verified in init().
+         * Compare ec_slave[ID].Ibytes and Sync Manager 3 length with the byte size of the TxPDO mapping.
+         * @note Use after ethercat configMap(). No SDO access.
+         * @return true if successed. Otherwise errorMessage holds the difference.
+         */
+        bool verifyTxPDO(void);
+
+        /**
+         * @brief Set and verify synchronization mode of input sampling.
+         * SM3 mode also sets the speed calculation cycle time. (0x2201) DC mode activates SYNC0 of slave.
+         * @param mode is SYNC_MODE_xxx.
+         * @param cycleTimeNs is process data cycle time of master. [ns] Not used for free run.
+         * @param sync0ShiftNs is SYNC0 shift from DC cycle start. [ns] Only for DC mode.
+         * @note Use in PRE_OP state. For DC mode use after ethercat configdc().
+         * @return true if successed. EAL580B_ERR_SYNC if mode is not supported or read back value is different.
+         */
+        bool setSyncMode(uint8_t mode, uint32_t cycleTimeNs, int32_t sync0ShiftNs = 0);
+
+        /// @brief Return synchronization mode set by setSyncMode(). SYNC_MODE_xxx.
+        uint8_t getSyncMode(void) const {return _syncMode;}
+
+        /**
+         * @brief Read synchronization state of device and calculate achieved sample to frame offset.
+         * @note Use when cyclic process data is running, so DC time of frames is current. Not for cycle time. (SDO access)
+         * @return true if successed.
+         */
+        bool getSyncReport(SyncReportStruct &report);
+
         /**
          * Save all parameters in EEPROM memory.
          * @return true if successed.
@@ -145,12 +495,24 @@ class EAL580B
          *  */ 
         uint16_t getPositionValue2BytesSDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getPositionValue2BytesSDO(uint16_t* data);
+
         /**
          * Get PositionValue2Bytes in PDO mode.
          * @note Hint: Use this function just when PositionValue2Bytes exist in TxPDO mapping, otherwise it return incorrect value.
          *  */ 
         uint16_t getPositionValue2BytesPDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return EAL580B_ERR_PDO_NOT_MAPPED if object is not in TxPDO mapping.
+         *  */
+        EAL580B_Status getPositionValue2BytesPDO(uint16_t* data);
+
         /**
          * Get SpeedValue4Bytes in SDO mode.
          * For each scaling option the measured value is provided as a „signed integer“. 
@@ -160,6 +522,12 @@ class EAL580B
          *  */ 
         int32_t getSpeedValue4BytesSDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getSpeedValue4BytesSDO(int32_t* data);
+
         /**
          * Get SpeedValue4Bytes in PDO mode.
          * For each scaling option the measured value is provided as a „signed integer“. 
@@ -169,6 +537,12 @@ class EAL580B
          *  */ 
         int32_t getSpeedValue4BytesPDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return EAL580B_ERR_PDO_NOT_MAPPED if object is not in TxPDO mapping.
+         *  */
+        EAL580B_Status getSpeedValue4BytesPDO(int32_t* data);
+
         /** 
          * Configure the speed calculation which affects the speed value of the encoder
          * @param config: value for configuration.
@@ -188,36 +562,72 @@ class EAL580B
          *  */ 
         int32_t getSensorTemperatureSDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getSensorTemperatureSDO(int32_t* data);
+
         /**
          * Get SensorTemperature in PDO mode.
          * @note Hint: Use this function just when SensorTemperature exist in TxPDO mapping, otherwise it return incorrect value.
          *  */ 
         int32_t getSensorTemperaturePDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return EAL580B_ERR_PDO_NOT_MAPPED if object is not in TxPDO mapping.
+         *  */
+        EAL580B_Status getSensorTemperaturePDO(int32_t* data);
+
         /**
          * Get scaled PositionValue in SDO mode.
          * @return always 0 if not successed.
          *  */ 
         uint32_t getPositionValueSDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getPositionValueSDO(uint32_t* data);
+
         /**
          * Get scaled PositionValue in PDO mode.
          * @note Hint: Use this function just when PositionValue exist in TxPDO mapping, otherwise it return incorrect value.
          *  */ 
         uint32_t getPositionValuePDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return EAL580B_ERR_PDO_NOT_MAPPED if object is not in TxPDO mapping.
+         *  */
+        EAL580B_Status getPositionValuePDO(uint32_t* data);
+
         /**
          * Get PositionRawValue in SDO mode.
          * @return always 0 if not successed.
          *  */ 
         uint32_t getPositionRawValueSDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getPositionRawValueSDO(uint32_t* data);
+
         /**
          * Get PositionRawValue in PDO mode.
          * @note Hint: Use this function just when PositionRawValue exist in TxPDO mapping, otherwise it return incorrect value.
          *  */ 
         uint32_t getPositionRawValuePDO(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return EAL580B_ERR_PDO_NOT_MAPPED if object is not in TxPDO mapping.
+         *  */
+        EAL580B_Status getPositionRawValuePDO(uint32_t* data);
+
         /**
          * @brief Position data behavior relates to the rotation direction of the shaft of the encoder when looking at the flange.
          * @param dir is direction behavior. 0: CW, 1:CCW     
@@ -244,6 +654,12 @@ class EAL580B
          *  */ 
         uint32_t getSingleTurnResolution(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getSingleTurnResolution(uint32_t* data);
+
         /**
          * @brief Get total measuring range (TMR).
          * This is the maximum value for PositionValue4byte and PositionValue2byte.
@@ -251,6 +667,12 @@ class EAL580B
          *  */ 
         uint32_t getTotalMeasuringRange(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getTotalMeasuringRange(uint32_t* data);
+
         /**
          * Set total measuring range (TMR).
          * This is maximum value for PositionValue4byte and PositionValue2byte.
@@ -286,6 +708,12 @@ class EAL580B
          *  */ 
         uint32_t getNumberOfDistinguishableRevolutions(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getNumberOfDistinguishableRevolutions(uint32_t* data);
+
         /**
          * the preset offset of the encoder. The value of this object is calculated when object 0x6003 (preset)
          * is written or when a preset is triggered via the push button.
@@ -293,6 +721,12 @@ class EAL580B
          *  */  
         int32_t getOffsetValue(void);
 
+        /**
+         * @brief Same as above with status result. Value is written to data only if successed.
+         * @return Status with error code, working counter and SDO abort code.
+         *  */
+        EAL580B_Status getOffsetValue(int32_t* data);
+
         /**
          * @brief Set the PresetValue object that contains the desired absolute preset value. Writing this object executes a preset.
          * The encoder internally calculates a preset offset value which is being stored in a non-volatile memory
@@ -313,17 +747,213 @@ class EAL580B
          *  */  
         bool setPresetValueDeg(float value);
 
+        /**
+         * @brief Set host-side preset. Position is set to value at the next decoded sample. No SDO access.
+         * The offset is applied in the conversion stage after virtual offset and before GEAR_RATIO, like setPresetValueDeg().
+         * @param value is desired angle value[deg] for position at last decoded position.
+         * @note Safe from any thread. Device position and its stored offset are not changed.
+         */
+        void setSoftPresetDeg(double value);
+
+        /**
+         * @brief Set host-side preset offset directly. Decoded position step is reduced by offset. [step]
+         * @note Safe from any thread.
+         */
+        void setSoftPresetStep(int64_t offset) {_softOffset.store(offset, std::memory_order_release);}
+
+        /// @brief Return host-side preset offset. [step]
+        int64_t getSoftPresetStep(void) const {return _softOffset.load(std::memory_order_acquire);}
+
+        /// @brief Remove host-side preset.
+        void clearSoftPreset(void) {setSoftPresetStep(0);}
+
+        /**
+         * @brief Write host-side preset to the device preset (0x6003). Not for cycle time. (SDO access)
+         * The host-side offset is not cleared here. The decode thread moves it at the first sample that shows
+         * the device jump, so the position is never shifted twice and never jumps.
+         * @note Device sets its position at write time. Motion during the SDO round trip stays in the host-side
+         * offset as a small rest. Use when shaft stands still for a zero rest. Multiples of the total measuring
+         * range can not be written to the device and stay host-side too.
+         * @return true if successed. false if not successed or the last commit is still pending.
+         * Host-side preset is kept if not successed.
+         */
+        bool commitSoftPreset(void);
+
+        /**
+         * @brief Bring slave back to OP after state loss with cached configuration. One state step per call.
+         * Error states are acknowledged. A reconfigured or recovered slave gets only the identity check (0x1018)
+         * and the settings of init() written again: rotation direction, speed unit, sync mode and TxPDO assignment.
+         * Device constants and TxPDO mapping are not read again. If writing fails, the slave is set back to INIT
+         * and reconfigured again in the next steps. It is never requested to OP without the cached configuration.
+         * If identity is different, the slave is set to INIT and RECOVERY_FAILED is returned.
+         * @note A step can block: reconfiguration and slave recovery wait up to EC_TIMEOUTMON, the state check
+         * up to EC_TIMEOUTRET, and reconfiguration waits for its SDO transfers. Not for the process data thread.
+         * Use periodically in a supervisor thread after ec_readstate(), while process data cycle goes on.
+         * Use after init().
+         * @return RECOVERY_xxx. RECOVERY_FAILED is kept until resetRecovery().
+         */
+        uint8_t recover(void);
+
+        /**
+         * @brief Allow recover() again after RECOVERY_FAILED. Identity is still checked against init().
+         * @note Use after the right device is connected again. Use init() to accept another device.
+         */
+        void resetRecovery(void);
+
+        /// @brief Return true while a recovery is in progress.
+        bool isRecovering(void) const {return _recovering;}
+
+        /**
+         * @brief Return SDO round trip statistic and current timeout of an object class.
+         * @param sdoClass is SDO_CLASS_xxx.
+         */
+        SdoTimingStruct getSdoTiming(uint8_t sdoClass) const;
+
+        /// @brief Return true if SDO breaker is open. (slave did not respond to the last transfers)
+        bool isSdoBreakerOpen(void) const;
+
+        /// @brief Clear SDO round trip statistics and close SDO breaker. e.g. after slave replacement.
+        void resetSdoTiming(void);
+
+        /**
+         * @brief Return position predicted to a host time. [deg]
+         * Last sample is extrapolated from its estimated sampling instant with decoded velocity,
+         * or with estimated velocity if SpeedValue4Bytes is not in TxPDO mapping.
+         * @param hostTimeNs is host time in nowNs() time base. e.g. the control instant.
+         */
+        double getPositionDegAt(uint64_t hostTimeNs);
+
+        /**
+         * @brief Return estimated delay from position sampling in encoder until sample decode in host. [ns]
+         * @note With SystemTime in TxPDO mapping the jitter part is learned from SystemTime against host time.
+         * Otherwise half of the measured update period is used. (mean sample age of free-run encoder)
+         * parameters.SAMPLE_DELAY_US is added in both cases.
+         */
+        uint64_t getSampleDelayNs(void) const {return _sampleDelayNs;}
+
+        /// @brief Return velocity used for extrapolation. [deg/s]
+        double getVelocityDegSec(void) const;
+
+        /// @brief Return host steady clock time now. [ns]
+        static uint64_t nowNs(void);
+
+        /**
+         * @brief Return status of last SDO operation or last error.
+         */
+        const EAL580B_Status& getStatus(void) const {return _status;}
+
+        /**
+         * @brief Read a typed object by SDO. Object type and access are checked at compile time.
+         * @note Descriptors are in EAL580B_objDict.h. e.g. readObject<EAL580B_OD::SensorTemperature>(&data)
+         * @return Status with error code, working counter and SDO abort code. Value is written to data only if successed.
+         */
+        template<typename OBJ>
+        EAL580B_Status readObject(typename OBJ::Type* data);
+
+        /**
+         * @brief Write a typed object by SDO. Object type and access are checked at compile time.
+         * @return Status with error code, working counter and SDO abort code.
+         */
+        template<typename OBJ>
+        EAL580B_Status writeObject(typename OBJ::Type value);
+
+        /**
+         * @brief Read many typed objects in order. Stop at first failure.
+         * @note e.g. readObjects<EAL580B_OD::SingleTurnResolution, EAL580B_OD::TotalMeasuringRange>(&res, &range)
+         * @return Status of first failed read or last read.
+         */
+        template<typename... OBJ>
+        EAL580B_Status readObjects(typename OBJ::Type*... data);
+
+        /**
+         * @brief Copy input slice of encoder from IOmap into the double buffered snapshot.
+         * Use in bus thread right after ec_receive_processdata(). Only a memory copy. Lock-free.
+         * @param cycle is bus cycle counter of application.
+         * @param wkc is working counter of cycle. -1 if unknown.
+         * @return false if input size of slave is more than SNAPSHOT_BYTES_MAX.
+         */
+        bool captureInputs(uint64_t cycle, int wkc = -1);
+
+        /**
+         * @brief Read latest captured snapshot. Safe from any thread. Never blocks captureInputs().
+         * @return false if nothing captured yet or capture was too fast for a consistent copy.
+         */
+        bool readSnapshot(InputSnapshotStruct &snapshot) const;
+
+        /**
+         * @brief Decode latest captured snapshot and update value variables. Use in decode thread.
+         * Decoding uses only the snapshot copy, never the live IOmap. After the first call the PDO getter
+         * functions read the last decoded snapshot too.
+         * @return false if there is no new snapshot since last call.
+         */
+        bool updateValuesSnapshot(void);
+
         /**
          * @brief Update value variables in PDO mode. 
+         * @note value.status is derived from slave state and SystemTime advance. Use updateValuesPDO(wkc) for working counter check too.
          */
         void updateValuesPDO(void);
 
+        /**
+         * @brief Update value variables in PDO mode and validate sample.
+         * @param wkc is working counter returned by ec_receive_processdata() of this cycle.
+         * @note value.status is derived from group working counter, slave state and SystemTime advance (if mapped).
+         */
+        void updateValuesPDO(int wkc);
+
+        /**
+         * Get SystemTime in PDO mode.
+         * @note Hint: Use this function just when SystemTime exist in TxPDO mapping, otherwise it return incorrect value.
+         *  */ 
+        uint32_t getSystemTimePDO(void);
+
         /**
          * @brief Update value variables in SDO mode.
          */
         void updateValuesSDO(void);
 
+        /**
+         * @brief Attach sample recorder. Each updateValuesPDO() and updateValuesSDO() appends one record.
+         * @param recorder is an opened recorder. nullptr detach recorder.
+         * @note One recorder can be attached to many encoders that are updated in the same thread.
+         */
+        void attachRecorder(EAL580B_Recorder* recorder);
+
+        /**
+         * @brief Attach shared memory publisher. Each update publishes value to the slot.
+         * @param publisher is an opened publisher. nullptr detach publisher.
+         * @param slot is publisher slot of this encoder.
+         */
+        void attachPublisher(EAL580B_ShmPublisher* publisher, uint16_t slot);
+
+        /**
+         * @brief Attach decimator. Each update adds value to all decimation windows of the slot.
+         * @param decimator is an initialized decimator. nullptr detach decimator.
+         * @param slot is decimator slot of this encoder.
+         */
+        void attachDecimator(EAL580B_Decimator* decimator, uint16_t slot);
+
+        /**
+         * @brief Attach position history. Each update appends value at its estimated sampling instant.
+         * (value.timeNs - getSampleDelayNs())
+         * @param history is an initialized history of this encoder only. nullptr detach history.
+         */
+        void attachHistory(EAL580B_History* history);
+
+        /**
+         * @brief Attach PDO to SDO failover. Used by EAL580B_Failover::add().
+         * Not valid PDO samples take the latest SDO polled values of the mapped objects with SAMPLE_DEGRADED.
+         * Without a new polled sample, last values are held with SAMPLE_DEGRADED | SAMPLE_HELD. Held samples keep
+         * value.timeNs and are not pushed to history and decimator.
+         * @param failover is failover object. nullptr detach failover.
+         * @param slot is failover slot of this encoder.
+         */
+        void attachFailover(EAL580B_Failover* failover, uint16_t slot);
+
     private:
+
+        friend class EAL580B_Async;
+        friend class EAL580B_Failover;
         
         // Max one revolution steps value for encoder.
         uint32_t _oneRevolutionMaxSteps;       
@@ -336,9 +966,111 @@ class EAL580B
 
         uint32_t _virtualOffset;
 
-        // Access the process data inputs.
+        // Identity read in init(). (0x1018)
+        struct _IdentityStruct
+        {
+            uint32_t vendorId;
+            uint32_t productCode;
+            uint32_t serialNumber;
+        }_identity;
+
+        // Recovery state.
+        bool _recovering;
+        bool _recoveryFailed;
+        bool _reconfigFailed;               // Last _PO2SOrecovery() did not reapply the configuration.
+        uint64_t _recoveryStartNs;
+
+        // Encoder of each slave during recovery. Used by _PO2SOrecovery().
+        static EAL580B* _recoveryRegistry[EC_MAXSLAVE];
+
+        // PRE_OP to SAFE_OP hook of SOEM during slave reconfiguration. Reapply cached configuration.
+        static int _PO2SOrecovery(uint16 slave);
+
+        // Check identity and write cached configuration. Slave must be in PRE_OP.
+        bool _reapplyConfig(void);
+
+        // Read identity object.
+        bool _readIdentity(_IdentityStruct &identity);
+
+        // Host-side preset offset. [step] Written from any thread, read once per conversion.
+        std::atomic<int64_t> _softOffset;
+
+        // Last decoded position step for soft preset from other threads.
+        std::atomic<uint32_t> _lastPosStep;
+
+        // State of committed soft preset. (_presetWritten)
+        static const uint8_t _PRESET_IN_FLIGHT = 0;
+        static const uint8_t _PRESET_WRITTEN = 1;
+        static const uint8_t _PRESET_FAILED = 2;
+
+        // Samples after end of commit write without device jump. Then the commit result decides.
+        static const uint8_t _PRESET_WAIT_MAX = 16;
+
+        // Expected device step change of pending commit. 0 if no commit is pending. Set by commitSoftPreset(),
+        // cleared by decode thread.
+        std::atomic<int64_t> _presetExpect;
+        std::atomic<uint8_t> _presetWritten;
+
+        // Number of preset writes in transfer. Glitch detection is off while a device preset can show up.
+        std::atomic<uint32_t> _presetBusy;
+
+        // Request of other threads to restart glitch detection and velocity estimation at next sample.
+        std::atomic<bool> _glitchReset;
+
+        // Decode thread state of preset tracking: previous position step, its step change, samples waited
+        // and number of known consecutive valid samples. (0..2)
+        uint32_t _presetPrevStep;
+        int64_t _presetPrevDelta;
+        uint8_t _presetWait;
+        uint8_t _presetHistory;
+
+        // Decode thread: consume glitch reset request before sample validation.
+        void _consumeGlitchReset(void);
+
+        // Decode thread: move host-side offset of pending commit at device jump. valid is false for a not valid sample.
+        void _trackPreset(bool valid);
+
+        // Wrap step change to +-range/2 of total measuring range.
+        int64_t _wrapStep(int64_t delta) const;
+
+        // Attached sample recorder. nullptr if not attached.
+        EAL580B_Recorder* _recorder;
+
+        // Access the process data inputs. nullptr means live ec_slave[].inputs.
         uint8 *_inputs;
 
+        // Attached shared memory publisher and its slot. nullptr if not attached.
+        EAL580B_ShmPublisher* _publisher;
+        uint16_t _publisherSlot;
+
+        // Attached decimator and its slot. nullptr if not attached.
+        EAL580B_Decimator* _decimator;
+        uint16_t _decimatorSlot;
+
+        // Attached position history. nullptr if not attached.
+        EAL580B_History* _history;
+
+        // Attached failover and its slot. nullptr if not attached.
+        EAL580B_Failover* _failover;
+        uint16_t _failoverSlot;
+
+        // Degraded mode state of failover.
+        bool _degraded;
+        uint32_t _failoverValidRun;
+
+        // Last good values. Held while no new polled sample exists. [step]
+        uint32_t _holdPosStep;
+        uint32_t _holdPosRawStep;
+        uint16_t _holdPos2BytesStep;
+        int32_t _holdVelStep;
+        uint64_t _holdTimeNs;
+
+        // Replace not valid PDO sample with polled sample. Return true if PDO values are used.
+        bool _applyFailover(void);
+
+        // Replay object in replay mode. nullptr if not in replay mode.
+        EAL580B_Replay* _replay;
+
         // rank range: 1, 2, 3, 4, 5, 6, 7
         uint8_t _TxPDO_rank;     
 
@@ -362,14 +1094,15 @@ class EAL580B
         uint8_t _TxMapFlag[6] = {0, 0, 0, 0, 0, 0};
 
         /**
-         * @brief Set TxPDO object vector.
-         * Elements of mapping array can be:
+         * @brief Set TxPDO offsets from object vector.
+         * Known elements of mapping array are:
          * @brief 1) MapValue_SystemTime
          * @brief 2) MapValue_PositionValue2Bytes
          * @brief 3) MapValue_SpeedValue4Bytes
          * @brief 4) MapValue_SensorTemperature
          * @brief 5) MapValue_PositionValue
          * @brief 6) MapValue_PositionRawValue   
+         * Other objects are skipped by their bit length.
          * 
          * @param num_enteries: number of object that want to set in PDO mapping.
          * @param mapping_entry: array of objects for set PDO mapping.
@@ -381,10 +1114,261 @@ class EAL580B
          *  */ 
         bool _setTxPDO(uint8_t num_enteries, uint32_t* mapping_entry);
 
+        // Status of last SDO operation or last error.
+        EAL580B_Status _status;
+
+        // Max number of SOEM error list entries inspected for abort code.
+        static const int _ERROR_LIST_MAX = 16;
+
+        // Lock of the global SOEM error list for _takeAbortCode().
+        static std::mutex _errorListMutex;
+
+        /**
+         * @brief SDO read of encoder object. Record status and error event if not successed.
+         * @return working counter.
+         */
+        int _SDOread(uint16_t index, uint8_t subindex, int* size, void* data);
+
+        /**
+         * @brief SDO write of encoder object. Record status and error event if not successed.
+         * @return working counter.
+         */
+        int _SDOwrite(uint16_t index, uint8_t subindex, int size, const void* data);
+
+        /**
+         * @brief SDO transfer with learned timeout, retries and breaker. Used by _SDOread() and _SDOwrite().
+         * @param size is data size. For read it is buffer size and is set to response size.
+         * @return working counter.
+         */
+        int _SDOtransfer(bool write, uint16_t index, uint8_t subindex, int* size, void* data);
+
+        // Lock of SDO timing and breaker state. Transfers of many threads update them. Not held during transfers.
+        mutable std::mutex _sdoMutex;
+
+        // Round trip statistics of SDO_CLASS_xxx.
+        SdoTimingStruct _sdoTiming[SDO_CLASS_NUM];
+
+        // Consecutive SDO transfers without response.
+        uint8_t _sdoFails;
+
+        // Time of SDO breaker opening. [ns] 0 means closed.
+        uint64_t _sdoBreakerOpenNs;
+
+        // Return SDO_CLASS_xxx of object.
+        static uint8_t _sdoClass(uint16_t index);
+
+        // Return timeout of next transfer of SDO_CLASS_xxx. [us] Initial timeout if class has no round trip sample.
+        uint32_t _sdoTimeoutUs(uint8_t sdoClass) const;
+
+        // Add round trip sample to statistic and update timeout.
+        void _sdoAddSample(SdoTimingStruct &timing, uint32_t rttUs);
+
+        // Take abort code of SDO transfer from SOEM error list. Errors of other transfers are pushed back. 0 if not found.
+        uint32_t _takeAbortCode(uint16_t index, uint8_t subindex);
+
+        // Record failed SDO transfer. EAL580B_ERR_SDO_ABORT if abortCode is not 0.
+        void _setErrorSDO(uint8_t code, uint16_t index, uint8_t subindex, int wkc, uint32_t abortCode);
+
+        // Record error. message must be a static string.
+        void _setError(uint8_t code, const char* message);
+
+        // Record error status in status, errorMessage and error ring. message must be a static string.
+        void _recordError(const EAL580B_Status &status, const char* message);
+
+        // Calculate conversion gains and offsets from device constants.
+        void _initConversion(void);
+
+        /**
+         * @brief Select TxPDO rank and set TxPDO offsets by parameters.PDOMAP_CONFIG_TYPE.
+         * @param assign: true -> assign rank in device by SDO. false -> just set offsets. (replay mode)
+         * @return true if successed.
+         */
+        bool _initTxMapping(bool assign);
+
+        // Number of fixed TxPDO ranks of device. (0x1A00 to 0x1A06)
+        static const int _TXPDO_RANK_NUM = 7;
+
+        // Max number of entries of one TxPDO mapping object.
+        static const int _TXPDO_ENTRY_MAX = 8;
+
+        // TxPDO mapping of all ranks as read from device. num 0 means rank is not usable.
+        struct _TxPDOTableStruct
+        {
+            uint8_t num[_TXPDO_RANK_NUM];
+            uint32_t entry[_TXPDO_RANK_NUM][_TXPDO_ENTRY_MAX];
+        };
+
+        // Read mapping of all TxPDO ranks from device.
+        bool _readTxPDOTable(_TxPDOTableStruct &table);
+
+        // Read mapping entries of one TxPDO rank from device. Return false if not readable.
+        bool _readTxPDOMapping(int pdo_rank, uint8_t &num, uint32_t* entries);
+
+        /**
+         * @brief Read SM3 assignment and mapping of selected rank from device and check them with decode offsets.
+         * @return true if successed. Otherwise errorMessage holds the difference.
+         */
+        bool _verifyTxMapping(void);
+
+        // Check SM3 assignment and mapping entries of device with decode offsets. Set _TxPDO_bytes.
+        bool _checkTxMapping(uint8_t assignedNum, uint16_t assignedIndex, uint8_t num, const uint32_t* entries);
+
+        // Byte size of selected TxPDO as verified from device.
+        uint16_t _TxPDO_bytes;
+
+        // Text of last mapping difference. errorMessage points to it after a mapping check failed.
+        char _mappingText[128];
+
+        // Synchronization mode set by setSyncMode().
+        uint8_t _syncMode;
+        uint32_t _syncCycleNs;
+        int32_t _syncShiftNs;
+
+        // Check mode against supported synchronization types. (0x1C33:4)
+        bool _checkSyncType(uint8_t mode, uint16_t supported);
+
+        // Store mode and set DC SYNC0 of slave for it.
+        void _applySyncMode(uint8_t mode, uint32_t cycleTimeNs, int32_t sync0ShiftNs);
+
+        // Sample to frame offset for report values. [ns]
+        int64_t _sampleOffsetNs(uint32_t shiftTimeNs, uint32_t calcCopyTimeNs) const;
+
+        /**
+         * @brief Select the TxPDO rank with the fewest bytes that covers signals.
+         * @return rank. 0 if no rank covers signals.
+         */
+        int _selectTxPDO(const _TxPDOTableStruct &table, uint8_t signals);
+
+        /**
+         * @brief Select TxPDO rank by parameters.PDO_SIGNALS and set TxPDO offsets from device mapping.
+         * @param assign: true -> assign rank in device by SDO.
+         * @return true if successed.
+         */
+        bool _initTxSignals(const _TxPDOTableStruct &table, bool assign);
+
+        // Return process data inputs of encoder. Replay buffer in replay mode.
+        uint8* _getInputs(void);
+
+        // Sample timing state for position extrapolation:
+        // Unwrapped SystemTime of encoder. [ns]
+        uint64_t _deviceTimeNs;
+
+        // Minimum of (host time - device time) seen. Clock offset plus minimum transfer latency. [ns]
+        int64_t _minHostDeviceNs;
+
+        // Estimated update period. [ns]
+        double _periodNs;
+
+        // Estimated delay from sampling to decode. [ns]
+        uint64_t _sampleDelayNs;
+
+        // Velocity estimated from position differences. [deg/s]
+        double _velEstDegSec;
+
+        // Previous sample for velocity estimation. Device position, so soft preset changes are not a motion.
+        uint32_t _prevPosStep;
+        bool _prevPosValid;
+        bool _timingValid;
+
+        // Max consecutive glitches. Then position jump is taken as real.
+        static const uint8_t _GLITCH_RUN_MAX = 4;
+
+        // Glitch detection state: previous accepted position step, its step change and number of known samples. (0..2)
+        uint32_t _glitchPrevStep;
+        int64_t _glitchPrevDelta;
+        uint8_t _glitchHistory;
+        uint8_t _glitchRun;
+
+        // Check value.posStep against predicted bound. Return SAMPLE_GLITCH or SAMPLE_VALID.
+        uint8_t _checkGlitch(void);
+
+        // Stamp sample with host time and update delay and velocity estimation. useSystemTime is false for SDO samples.
+        void _updateValuesTiming(bool useSystemTime);
+
+        // Validate new PDO sample. Set value.status and sampleCounter. wkc < 0 means working counter is unknown.
+        void _validateSample(int wkc);
+
+        // Decode PDO inputs of _getInputs() and feed consumers. Slave state is from _sampleState and _sampleLost.
+        void _decodePDO(int wkc);
+
+        // Slave state of decoded sample.
+        uint16_t _sampleState;
+        bool _sampleLost;
+
+        // Capture time of decoded snapshot. [ns] 0 means decode time is used.
+        uint64_t _sampleTimeNs;
+
+        struct _SnapshotSlotStruct
+        {
+            // Seqlock sequence. Odd while writing.
+            std::atomic<uint64_t> seq;
+            InputSnapshotStruct snapshot;
+        };
+
+        // Double buffer of input snapshots. Capture number n is in slot n % 2.
+        _SnapshotSlotStruct _snapshots[2];
+
+        // Number of captures.
+        std::atomic<uint64_t> _snapshotCount;
+
+        // Snapshot owned by decode thread. Decoded inputs point to it.
+        InputSnapshotStruct _decodeSnapshot;
+
         // Update values for convert values to deg unit for angles and deg/sec unit for speed.
         void _updateValuesConversion(void);
 
+        // Feed new converted values to consumer stages. (position compare, ...)
+        void _updateValuesConsumers(void);
+
 };
 
+// #################################################################################
+// Template functions:
+
+template<typename OBJ>
+EAL580B_Status EAL580B::readObject(typename OBJ::Type* data)
+{
+    static_assert(OBJ::readable, "Object is not readable.");
+
+    typename OBJ::Type buffer;
+    int size = OBJ::size;
+
+    if(_SDOread(OBJ::index, OBJ::subindex, &size, &buffer) <= 0)
+    {
+        return _status;
+    }
+
+    if(size != OBJ::size)
+    {
+        _recordError({EAL580B_ERR_SDO_SIZE, OBJ::subindex, OBJ::index, _status.wkc, 0}, "Error Encoder EAL580B: SDO response size does not match object type.");
+        return _status;
+    }
+
+    *data = buffer;
+
+    return _status;
+}
+
+template<typename OBJ>
+EAL580B_Status EAL580B::writeObject(typename OBJ::Type value)
+{
+    static_assert(OBJ::writable, "Object is not writable.");
+
+    _SDOwrite(OBJ::index, OBJ::subindex, OBJ::size, &value);
+
+    return _status;
+}
+
+template<typename... OBJ>
+EAL580B_Status EAL580B::readObjects(typename OBJ::Type*... data)
+{
+    bool state = true;
+
+    // Left fold keeps order and stops at first failure.
+    ((state = state && readObject<OBJ>(data).ok()), ...);
+
+    return _status;
+}
+
 
 #endif
\ No newline at end of file
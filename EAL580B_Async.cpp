@@ -0,0 +1,573 @@
+// Hint: This file needs C++20 coroutines. It is empty when compiled with an older standard.
+#if __cplusplus >= 202002L
+
+#include "EAL580B_Async.h"
+#include "EAL580B_objDict.h"        // Object dictionary of EAL580B
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+// EAL580B_Scheduler:
+
+size_t EAL580B_Scheduler::spawn(EAL580B_Task &&task)
+{
+    _tasks.push_back(std::move(task));
+    _notStarted.push_back(_tasks.size() - 1);
+
+    return _tasks.size() - 1;
+}
+
+size_t EAL580B_Scheduler::poll(void)
+{
+    // Start new tasks. They run until their first mailbox exchange or delay.
+    std::vector<size_t> starting;
+    starting.swap(_notStarted);
+
+    for(size_t i : starting)
+    {
+        _tasks[i]._handle.resume();
+    }
+
+    // Resume due timers. Resumed tasks may add new timers, so due timers are taken out first.
+    if(!_timers.empty())
+    {
+        uint64_t now = EAL580B::nowNs();
+        std::vector<std::coroutine_handle<>> due;
+
+        for(size_t i = 0; i < _timers.size(); )
+        {
+            if(_timers[i].deadlineNs <= now)
+            {
+                due.push_back(_timers[i].handle);
+                _timers[i] = _timers.back();
+                _timers.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        for(std::coroutine_handle<> handle : due)
+        {
+            handle.resume();
+        }
+    }
+
+    // Check each busy mailbox once.
+    for(auto &item : _slaves)
+    {
+        _SlaveQueueStruct &slave = *item.second;
+
+        if(slave.queue.empty())
+        {
+            continue;
+        }
+
+        uint8_t state = slave.transfer.poll();
+
+        if(state == SDO_TRANSFER_BUSY)
+        {
+            continue;
+        }
+
+        if(state == SDO_TRANSFER_IDLE)
+        {
+            // Mailbox of slave was used by another user at start. Try again.
+            _startFront(slave);
+            continue;
+        }
+
+        SdoAwaiter *awaiter = slave.queue.front();
+        slave.queue.pop_front();
+
+        awaiter->status = slave.transfer.getStatus();
+
+        if( (state == SDO_TRANSFER_DONE) && (awaiter->write == false) )
+        {
+            slave.transfer.getData(awaiter->data, awaiter->size);
+        }
+
+        // Next request of slave is started before resume. Resumed task may queue a new request.
+        if(!slave.queue.empty())
+        {
+            _startFront(slave);
+        }
+
+        awaiter->handle.resume();
+    }
+
+    size_t unfinished = 0;
+
+    for(const EAL580B_Task &task : _tasks)
+    {
+        if(!task.done())
+        {
+            unfinished++;
+        }
+    }
+
+    return unfinished;
+}
+
+bool EAL580B_Scheduler::run(uint32_t pollPeriodUs)
+{
+    while(poll() > 0)
+    {
+        osal_usleep(pollPeriodUs);
+    }
+
+    bool state = true;
+
+    for(const EAL580B_Task &task : _tasks)
+    {
+        state = state && task.result();
+    }
+
+    return state;
+}
+
+void EAL580B_Scheduler::_enqueue(SdoAwaiter *awaiter)
+{
+    std::unique_ptr<_SlaveQueueStruct> &slave = _slaves[awaiter->slave];
+
+    if(slave == nullptr)
+    {
+        slave.reset(new _SlaveQueueStruct);
+    }
+
+    slave->queue.push_back(awaiter);
+
+    if(slave->queue.size() == 1)
+    {
+        _startFront(*slave);
+    }
+}
+
+void EAL580B_Scheduler::_startFront(_SlaveQueueStruct &slave)
+{
+    SdoAwaiter *awaiter = slave.queue.front();
+
+    // Send failure leaves transfer in error state. It is reported at next poll(). Busy mailbox lock leaves
+    // transfer idle. It is started again at next poll().
+    if(awaiter->write)
+    {
+        slave.transfer.startWrite(awaiter->slave, awaiter->index, awaiter->subindex, awaiter->data, awaiter->size);
+    }
+    else
+    {
+        slave.transfer.startRead(awaiter->slave, awaiter->index, awaiter->subindex);
+    }
+}
+
+// #######################################################################
+// EAL580B_Async:
+
+bool EAL580B_Async::_fail(EAL580B &encoder, const EAL580B_Status &status, const char* message)
+{
+    encoder._recordError(status, message);
+
+    return false;
+}
+
+EAL580B_Task EAL580B_Async::init(EAL580B_Scheduler &scheduler, EAL580B &encoder, bool readState)
+{
+    if(encoder.checkParameters() == false)
+    {
+        co_return false;
+    }
+
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+    uint32_t data = 0;
+    EAL580B_Status status;
+
+    status = co_await scheduler.sdoRead(slave, Index_SingleTurnResolution, 0, &data);
+
+    if( !status.ok() || (data == 0) )
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: getSingleTurnResolution() was not successed.");
+    }
+
+    encoder._oneRevolutionMaxSteps = data;
+
+    data = 0;
+    status = co_await scheduler.sdoRead(slave, Index_TotalMeasuringRange, 0, &data);
+
+    if( !status.ok() || (data == 0) )
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: getTotalMeasuringRange() was not successed.");
+    }
+
+    encoder._totalMeasuringMaxRange = data;
+
+    if(!co_await setRotationDirection(scheduler, encoder, encoder.parameters.ROTATION_DIR))
+    {
+        co_return false;
+    }
+
+    encoder._initConversion();
+
+    if(!co_await setSpeedMeasuringUnit(scheduler, encoder, encoder.parameters.SPD_UNIT))
+    {
+        co_return false;
+    }
+
+    if( (encoder.parameters.SYNC_MODE != SYNC_MODE_FREE_RUN) &&
+        !co_await setSyncMode(scheduler, encoder, encoder.parameters.SYNC_MODE, encoder.parameters.SYNC_CYCLE_NS) )
+    {
+        co_return false;
+    }
+
+    if(encoder.parameters.PDO_SIGNALS != 0)
+    {
+        EAL580B::_TxPDOTableStruct table;
+
+        if(!co_await _readTxPDOTable(scheduler, encoder, table))
+        {
+            co_return false;
+        }
+
+        // Offsets only. Rank is assigned below with the mailbox of this scheduler.
+        if(!encoder._initTxSignals(table, false))
+        {
+            co_return false;
+        }
+    }
+    else if(!encoder._initTxMapping(false))
+    {
+        co_return false;
+    }
+
+    if(!co_await assignTxPDO_rank(scheduler, encoder, encoder._TxPDO_rank, readState))
+    {
+        co_return false;
+    }
+
+    if(!co_await _verifyTxMapping(scheduler, encoder))
+    {
+        co_return false;
+    }
+
+    // Identity for hot reconnect. (EAL580B::recover())
+    uint32_t identity[3] = {0, 0, 0};
+    const uint8_t subindexes[3] = {1, 2, 4};
+
+    for(int i = 0; i < 3; i++)
+    {
+        status = co_await scheduler.sdoRead(slave, Index_IdentityObject, subindexes[i], &identity[i]);
+
+        if(!status.ok())
+        {
+            co_return _fail(encoder, status, "Error Encoder EAL580B: Identity object can not be read.");
+        }
+    }
+
+    encoder._identity = {identity[0], identity[1], identity[2]};
+    encoder._recoveryFailed = false;
+
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::_readTxPDOMapping(EAL580B_Scheduler &scheduler, EAL580B &encoder, int pdo_rank, uint8_t &num, uint32_t* entries)
+{
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+    uint16_t index = Index_TPDOmapping_1 + (pdo_rank - 1);
+
+    num = 0;
+
+    EAL580B_Status status = co_await scheduler.sdoRead(slave, index, 0, &num);
+
+    if( !status.ok() || (num == 0) || (num > EAL580B::_TXPDO_ENTRY_MAX) )
+    {
+        co_return false;
+    }
+
+    for(int subindex = 1; subindex <= num; subindex++)
+    {
+        status = co_await scheduler.sdoRead(slave, index, (uint8_t)subindex, &entries[subindex - 1]);
+
+        if(!status.ok())
+        {
+            co_return false;
+        }
+    }
+
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::_readTxPDOTable(EAL580B_Scheduler &scheduler, EAL580B &encoder, EAL580B::_TxPDOTableStruct &table)
+{
+    bool found = false;
+
+    for(int rank = 1; rank <= EAL580B::_TXPDO_RANK_NUM; rank++)
+    {
+        uint8_t num;
+
+        // A rank that can not be read is just not selected.
+        if(co_await _readTxPDOMapping(scheduler, encoder, rank, num, table.entry[rank - 1]))
+        {
+            table.num[rank - 1] = num;
+            found = true;
+        }
+        else
+        {
+            table.num[rank - 1] = 0;
+        }
+    }
+
+    if(!found)
+    {
+        encoder._setError(EAL580B_ERR_MAPPING, "Error Encoder EAL580B: TxPDO mapping can not be read from device.");
+    }
+
+    co_return found;
+}
+
+EAL580B_Task EAL580B_Async::_verifyTxMapping(EAL580B_Scheduler &scheduler, EAL580B &encoder)
+{
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+    uint8_t assignedNum = 0;
+    uint16_t assignedIndex = 0;
+    uint8_t num = 0;
+    uint32_t entries[EAL580B::_TXPDO_ENTRY_MAX];
+    EAL580B_Status status;
+
+    status = co_await scheduler.sdoRead(slave, EAL580B_OD::SyncManager3PDOAssignmentNum::index, EAL580B_OD::SyncManager3PDOAssignmentNum::subindex, &assignedNum);
+
+    if(status.ok())
+    {
+        status = co_await scheduler.sdoRead(slave, EAL580B_OD::SyncManager3PDOAssignment::index, EAL580B_OD::SyncManager3PDOAssignment::subindex, &assignedIndex);
+    }
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: 0x1C13 can not be read.");
+    }
+
+    if(!co_await _readTxPDOMapping(scheduler, encoder, encoder._TxPDO_rank, num, entries))
+    {
+        encoder._setError(EAL580B_ERR_MAPPING, "Error Encoder EAL580B: TxPDO mapping of selected rank can not be read.");
+        co_return false;
+    }
+
+    co_return encoder._checkTxMapping(assignedNum, assignedIndex, num, entries);
+}
+
+EAL580B_Task EAL580B_Async::assignTxPDO_rank(EAL580B_Scheduler &scheduler, EAL580B &encoder, int pdo_rank, bool readState)
+{
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+
+    // Read state of all slaves in ethercat.
+    if(readState)
+    {
+        ec_readstate();
+    }
+
+    if(ec_slave[slave].state != EC_STATE_PRE_OP)
+    {
+        encoder._setError(EAL580B_ERR_STATE, "Error Encoder EAL580B: Assign TxPDO rank not successed beacuse salve not in pre operational state.");
+        co_return false;
+    }
+
+    if( (pdo_rank < 1) || (pdo_rank > 7) )
+    {
+        encoder._setError(EAL580B_ERR_PARAMETER, "Error Encoder: assignTxPDO_rank() was not successed.");
+        co_return false;
+    }
+
+    // TxPDO mapping indexes are continuous from Index_TPDOmapping_1.
+    uint16_t index = Index_TPDOmapping_1 + (pdo_rank - 1);
+    uint8_t data = 0;
+    EAL580B_Status status;
+
+    status = co_await scheduler.sdoWrite(slave, Index_SyncManager3PDOAssignment, 0, &data);
+    co_await scheduler.delay(10000);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder: assignTxPDO_rank() was not successed.");
+    }
+
+    // Assign TxPDO index.
+    status = co_await scheduler.sdoWrite(slave, Index_SyncManager3PDOAssignment, 1, &index);
+    co_await scheduler.delay(10000);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder: assignTxPDO_rank() was not successed.");
+    }
+
+    data = 1;
+    status = co_await scheduler.sdoWrite(slave, Index_SyncManager3PDOAssignment, 0, &data);
+    co_await scheduler.delay(10000);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder: assignTxPDO_rank() was not successed.");
+    }
+
+    encoder._TxPDO_rank = pdo_rank;
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::setRotationDirection(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint8_t dir)
+{
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+    uint16_t data = 0;
+    EAL580B_Status status;
+
+    if(dir > 1)
+    {
+        encoder._setError(EAL580B_ERR_PARAMETER, "Error Encoder EAL580B: setRotationDirection() was not successed.");
+        co_return false;
+    }
+
+    status = co_await scheduler.sdoRead(slave, Index_OperatingParameters, 0, &data);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: setRotationDirection() was not successed.");
+    }
+
+    if(dir == 1)
+        data |= (1 << 0);
+    else
+        data &= ~(1 << 0);
+
+    status = co_await scheduler.sdoWrite(slave, Index_OperatingParameters, 0, &data);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: setRotationDirection() was not successed.");
+    }
+
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::setSpeedMeasuringUnit(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint8_t config)
+{
+    EAL580B_Status status = co_await scheduler.sdoWrite(encoder.parameters.ETHERCAT_ID, Index_SpeedCalculationConfiguration, 2, &config);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: setSpeedMeasuringUnit() was not successed.");
+    }
+
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::setSyncMode(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint8_t mode, uint32_t cycleTimeNs, int32_t sync0ShiftNs)
+{
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+    EAL580B_Status status;
+
+    if( (mode > SYNC_MODE_DC) || ((mode != SYNC_MODE_FREE_RUN) && (cycleTimeNs == 0)) )
+    {
+        encoder._setError(EAL580B_ERR_PARAMETER, "Error Encoder EAL580B: setSyncMode() was not successed. Mode or cycle time is not correct.");
+        co_return false;
+    }
+
+    if(mode != SYNC_MODE_FREE_RUN)
+    {
+        uint16_t supported = 0;
+        status = co_await scheduler.sdoRead(slave, Index_SyncManager3Parameter, 4, &supported);
+
+        if(!status.ok())
+        {
+            co_return _fail(encoder, status, "Error Encoder EAL580B: setSyncMode() was not successed.");
+        }
+
+        if(!encoder._checkSyncType(mode, supported))
+        {
+            co_return false;
+        }
+    }
+
+    uint16_t type = mode;
+    status = co_await scheduler.sdoWrite(slave, Index_SyncManager3Parameter, 1, &type);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: setSyncMode() was not successed.");
+    }
+
+    uint32_t speedCycle = cycleTimeNs / 1000;
+
+    if(mode == SYNC_MODE_SM3)
+    {
+        status = co_await scheduler.sdoWrite(slave, Index_SpeedCalculationCycleTime, 0, &speedCycle);
+
+        if(!status.ok())
+        {
+            co_return _fail(encoder, status, "Error Encoder EAL580B: setSyncMode() was not successed.");
+        }
+
+        speedCycle = 0;
+        status = co_await scheduler.sdoRead(slave, Index_SpeedCalculationCycleTime, 0, &speedCycle);
+
+        if(!status.ok())
+        {
+            co_return _fail(encoder, status, "Error Encoder EAL580B: setSyncMode() was not successed.");
+        }
+    }
+
+    type = 0xFFFF;
+    status = co_await scheduler.sdoRead(slave, Index_SyncManager3Parameter, 1, &type);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: setSyncMode() was not successed.");
+    }
+
+    if( (type != mode) || (speedCycle != cycleTimeNs / 1000) )
+    {
+        encoder._setError(EAL580B_ERR_SYNC, "Error Encoder EAL580B: setSyncMode() was not successed. Read back value is different.");
+        co_return false;
+    }
+
+    encoder._applySyncMode(mode, cycleTimeNs, sync0ShiftNs);
+
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::setGearFactorScale(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint32_t numerator, uint32_t denominator)
+{
+    uint16_t slave = encoder.parameters.ETHERCAT_ID;
+    EAL580B_Status status;
+
+    status = co_await scheduler.sdoWrite(slave, Index_GearFactorConfiguration, 2, &numerator);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder: setGearFactorScale() was not successed.");
+    }
+
+    status = co_await scheduler.sdoWrite(slave, Index_GearFactorConfiguration, 3, &denominator);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder: setGearFactorScale() was not successed.");
+    }
+
+    co_return true;
+}
+
+EAL580B_Task EAL580B_Async::setPresetValueStep(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint32_t value)
+{
+    // Preset jump is not a glitch. Same as EAL580B::setPresetValueStep().
+    encoder._presetBusy.fetch_add(1, std::memory_order_acq_rel);
+    EAL580B_Status status = co_await scheduler.sdoWrite(encoder.parameters.ETHERCAT_ID, Index_PresetValue, 0, &value);
+    encoder._presetBusy.fetch_sub(1, std::memory_order_acq_rel);
+    encoder._glitchReset.store(true, std::memory_order_release);
+
+    if(!status.ok())
+    {
+        co_return _fail(encoder, status, "Error Encoder EAL580B: setPresetValueStep() was not successed.");
+    }
+
+    co_return true;
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef _EAL580B_ASYNC_H
+#define _EAL580B_ASYNC_H
+
+// Hint: This header needs C++20 coroutines. Compile with -std=c++20.
+
+// Header Includes:
+#include <coroutine>                // C++20 coroutines
+#include <deque>                    // For request queues
+#include <map>                      // For per-slave queues
+#include <memory>                   // For unique_ptr
+#include <vector>                   // For task list
+#include "EAL580B.h"                // EAL580B encoder object
+#include "EAL580B_Mailbox.h"        // Non-blocking SDO transfer
+
+class EAL580B_Scheduler;
+
+// #################################################################################
+/**
+ * @brief Coroutine task of an asynchronous configuration sequence. Result is true if successed.
+ * A task starts when it is spawned on a scheduler or when it is awaited by another task.
+ */
+class EAL580B_Task
+{
+    public:
+
+        struct promise_type
+        {
+            bool result = false;
+            std::coroutine_handle<> continuation;
+
+            EAL580B_Task get_return_object() {return EAL580B_Task(std::coroutine_handle<promise_type>::from_promise(*this));}
+            std::suspend_always initial_suspend() noexcept {return {};}
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept {return false;}
+                void await_resume() noexcept {}
+
+                // Continue awaiting task if any.
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+            };
+
+            FinalAwaiter final_suspend() noexcept {return {};}
+            void return_value(bool value) {result = value;}
+            void unhandled_exception() {result = false;}
+        };
+
+        EAL580B_Task(EAL580B_Task &&other) noexcept : _handle(other._handle) {other._handle = nullptr;}
+        EAL580B_Task(const EAL580B_Task&) = delete;
+        ~EAL580B_Task() {if(_handle) _handle.destroy();}
+
+        /// @brief Return true if task finished.
+        bool done(void) const {return _handle && _handle.done();}
+
+        /// @brief Return result of finished task.
+        bool result(void) const {return done() && _handle.promise().result;}
+
+        // Awaiting a task starts it and resumes the awaiting task when it finished.
+        bool await_ready(void) const noexcept {return false;}
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {_handle.promise().continuation = awaiting; return _handle;}
+        bool await_resume(void) const {return _handle.promise().result;}
+
+    private:
+
+        friend class EAL580B_Scheduler;
+
+        std::coroutine_handle<promise_type> _handle;
+
+        explicit EAL580B_Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+};
+
+// #################################################################################
+/**
+ * @brief Single thread scheduler for asynchronous configuration tasks.
+ * Tasks suspend on each mailbox exchange. Each poll() checks all busy mailboxes once without waiting,
+ * so hundreds of sequences on many encoders progress together. Requests of one slave run in order.
+ */
+class EAL580B_Scheduler
+{
+    public:
+
+        /// Awaiter of one SDO transfer. Result is status of transfer.
+        struct SdoAwaiter
+        {
+            EAL580B_Scheduler *scheduler;
+            uint16_t slave;
+            uint16_t index;
+            uint8_t subindex;
+            bool write;
+            void *data;
+            int size;
+
+            EAL580B_Status status;
+            std::coroutine_handle<> handle;
+
+            bool await_ready(void) const noexcept {return false;}
+            void await_suspend(std::coroutine_handle<> awaiting) {handle = awaiting; scheduler->_enqueue(this);}
+            EAL580B_Status await_resume(void) const noexcept {return status;}
+        };
+
+        /// Awaiter of a time delay.
+        struct DelayAwaiter
+        {
+            EAL580B_Scheduler *scheduler;
+            uint64_t deadlineNs;
+
+            bool await_ready(void) const noexcept {return false;}
+            void await_suspend(std::coroutine_handle<> awaiting) {scheduler->_timers.push_back({deadlineNs, awaiting});}
+            void await_resume(void) const noexcept {}
+        };
+
+        /**
+         * @brief Return awaiter that reads an object into *data.
+         */
+        template<typename T>
+        SdoAwaiter sdoRead(uint16_t slave, uint16_t index, uint8_t subindex, T* data)
+        {
+            static_assert(sizeof(T) <= 4, "Only expedited SDO transfer is supported.");
+            return {this, slave, index, subindex, false, data, (int)sizeof(T), {EAL580B_OK, 0, 0, 0, 0}, nullptr};
+        }
+
+        /**
+         * @brief Return awaiter that writes value to an object.
+         * @note value must stay alive until awaiter resumes. It is always true for coroutine locals.
+         */
+        template<typename T>
+        SdoAwaiter sdoWrite(uint16_t slave, uint16_t index, uint8_t subindex, T* value)
+        {
+            static_assert(sizeof(T) <= 4, "Only expedited SDO transfer is supported.");
+            return {this, slave, index, subindex, true, value, (int)sizeof(T), {EAL580B_OK, 0, 0, 0, 0}, nullptr};
+        }
+
+        /// @brief Return awaiter that resumes after delay. [us]
+        DelayAwaiter delay(uint32_t us) {return {this, EAL580B::nowNs() + (uint64_t)us * 1000};}
+
+        /**
+         * @brief Take task and start it at next poll().
+         * @return Index of task for getResult().
+         */
+        size_t spawn(EAL580B_Task &&task);
+
+        /**
+         * @brief Progress all tasks once. Check busy mailboxes and due timers. No waiting.
+         * @return Number of unfinished tasks.
+         */
+        size_t poll(void);
+
+        /**
+         * @brief Run poll() until all tasks finished.
+         * @param pollPeriodUs is sleep time between polls. [us]
+         * @return true if all tasks successed.
+         */
+        bool run(uint32_t pollPeriodUs = 100);
+
+        /// @brief Return result of task by spawn index.
+        bool getResult(size_t index) const {return _tasks[index].result();}
+
+        /// @brief Remove finished tasks list. Spawn indexes restart from 0.
+        void clear(void) {_tasks.clear();}
+
+    private:
+
+        struct _TimerStruct
+        {
+            uint64_t deadlineNs;
+            std::coroutine_handle<> handle;
+        };
+
+        struct _SlaveQueueStruct
+        {
+            std::deque<SdoAwaiter*> queue;
+            EAL580B_SdoTransfer transfer;
+        };
+
+        std::vector<EAL580B_Task> _tasks;
+        std::vector<size_t> _notStarted;
+        std::vector<_TimerStruct> _timers;
+        std::map<uint16_t, std::unique_ptr<_SlaveQueueStruct>> _slaves;
+
+        // Queue SDO request of a suspended task.
+        void _enqueue(SdoAwaiter *awaiter);
+
+        // Start front request of slave queue.
+        void _startFront(_SlaveQueueStruct &slave);
+};
+
+// #################################################################################
+/**
+ * @brief Coroutine versions of EAL580B configuration functions.
+ * They do the same SDO sequences as the blocking functions but suspend on each mailbox exchange.
+ * @note Usage: scheduler.spawn(EAL580B_Async::init(scheduler, encoder)); scheduler.run();
+ */
+class EAL580B_Async
+{
+    public:
+
+        /**
+         * @brief Asynchronous EAL580B::init().
+         * @param readState false if ec_readstate() is done once by caller for all encoders.
+         */
+        static EAL580B_Task init(EAL580B_Scheduler &scheduler, EAL580B &encoder, bool readState = true);
+
+        /**
+         * @brief Asynchronous EAL580B::assignTxPDO_rank().
+         * @param readState false if ec_readstate() is done once by caller for all encoders.
+         */
+        static EAL580B_Task assignTxPDO_rank(EAL580B_Scheduler &scheduler, EAL580B &encoder, int pdo_rank, bool readState = true);
+
+        /// @brief Asynchronous EAL580B::setRotationDirection().
+        static EAL580B_Task setRotationDirection(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint8_t dir);
+
+        /// @brief Asynchronous EAL580B::setSpeedMeasuringUnit().
+        static EAL580B_Task setSpeedMeasuringUnit(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint8_t config);
+
+        /// @brief Asynchronous EAL580B::setSyncMode().
+        static EAL580B_Task setSyncMode(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint8_t mode, uint32_t cycleTimeNs, int32_t sync0ShiftNs = 0);
+
+        /// @brief Asynchronous EAL580B::setGearFactorScale().
+        static EAL580B_Task setGearFactorScale(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint32_t numerator, uint32_t denominator);
+
+        /// @brief Asynchronous EAL580B::setPresetValueStep().
+        static EAL580B_Task setPresetValueStep(EAL580B_Scheduler &scheduler, EAL580B &encoder, uint32_t value);
+
+    private:
+
+        // Read mapping of all TxPDO ranks from device.
+        static EAL580B_Task _readTxPDOTable(EAL580B_Scheduler &scheduler, EAL580B &encoder, EAL580B::_TxPDOTableStruct &table);
+
+        // Read mapping entries of one TxPDO rank from device. Result is false if not readable.
+        static EAL580B_Task _readTxPDOMapping(EAL580B_Scheduler &scheduler, EAL580B &encoder, int pdo_rank, uint8_t &num, uint32_t* entries);
+
+        // Asynchronous EAL580B::_verifyTxMapping().
+        static EAL580B_Task _verifyTxMapping(EAL580B_Scheduler &scheduler, EAL580B &encoder);
+
+        // Record failed transfer in encoder status and error ring. Return false.
+        static bool _fail(EAL580B &encoder, const EAL580B_Status &status, const char* message);
+};
+
+#endif
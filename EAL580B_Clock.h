@@ -0,0 +1,19 @@
+#ifndef _EAL580B_CLOCK_H
+#define _EAL580B_CLOCK_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <chrono>                   // For time managements
+
+// #################################################################################
+
+/**
+ * @brief Return host time now. [ns] Steady clock.
+ * @note The one time base of all EAL580B times. (sample times, error events, records, SDO timing)
+ */
+inline uint64_t EAL580B_nowNs(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
@@ -0,0 +1,216 @@
+#include "EAL580B_Decimator.h"
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_Decimator::EAL580B_Decimator()
+{
+    _slotNum = 0;
+    _ringSize = 0;
+}
+
+bool EAL580B_Decimator::init(uint16_t slotNum, const std::vector<uint32_t> &factors, uint32_t ringSize)
+{
+    if( (slotNum == 0) || (ringSize == 0) || ((ringSize & (ringSize - 1)) != 0) )
+    {
+        errorMessage = "Error Decimator: init() slot number or ring size is not correct.";
+        return false;
+    }
+
+    if( factors.empty() || (factors.size() > DECIMATOR_STREAM_MAX) )
+    {
+        errorMessage = "Error Decimator: init() stream number is not correct.";
+        return false;
+    }
+
+    for(uint32_t factor : factors)
+    {
+        if(factor == 0)
+        {
+            errorMessage = "Error Decimator: init() factor 0 is not correct.";
+            return false;
+        }
+    }
+
+    size_t num = (size_t)slotNum * factors.size();
+
+    _streams.reset(new _StreamStruct[num]);
+
+    for(size_t i = 0; i < num; i++)
+    {
+        _streams[i].acc.window.count = 0;
+        _streams[i].head.store(0, std::memory_order_relaxed);
+        _streams[i].ring.reset(new _EntryStruct[ringSize]);
+
+        for(uint32_t k = 0; k < ringSize; k++)
+        {
+            _streams[i].ring[k].seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    _slotNum = slotNum;
+    _ringSize = ringSize;
+    _factors = factors;
+
+    return true;
+}
+
+bool EAL580B_Decimator::push(uint16_t slot, const EAL580B::ValueStruct &value)
+{
+    if(slot >= _slotNum)
+    {
+        return false;
+    }
+
+    const size_t streamNum = _factors.size();
+    _StreamStruct *streams = &_streams[slot * streamNum];
+
+    for(size_t i = 0; i < streamNum; i++)
+    {
+        _add(streams[i], _factors[i], value);
+    }
+
+    return true;
+}
+
+void EAL580B_Decimator::_open(_AccumulatorStruct &acc, const EAL580B::ValueStruct &value)
+{
+    EAL580B_WindowStruct &w = acc.window;
+
+    w.startTimeNs = value.timeNs;
+    w.count = 0;
+    w.status = SAMPLE_VALID;
+    w.posMin = value.posDeg;
+    w.posMax = value.posDeg;
+    w.velMin = value.velDegSec;
+    w.velMax = value.velDegSec;
+    acc.posSum = 0;
+    acc.velSum = 0;
+}
+
+void EAL580B_Decimator::_add(_StreamStruct &stream, uint32_t factor, const EAL580B::ValueStruct &value)
+{
+    _AccumulatorStruct &acc = stream.acc;
+    EAL580B_WindowStruct &w = acc.window;
+
+    if(w.count == 0)
+    {
+        _open(acc, value);
+    }
+
+    w.count++;
+    w.endTimeNs = value.timeNs;
+    w.status |= value.status;
+    w.posMin = (value.posDeg < w.posMin) ? value.posDeg : w.posMin;
+    w.posMax = (value.posDeg > w.posMax) ? value.posDeg : w.posMax;
+    w.posLast = value.posDeg;
+    w.velMin = (value.velDegSec < w.velMin) ? value.velDegSec : w.velMin;
+    w.velMax = (value.velDegSec > w.velMax) ? value.velDegSec : w.velMax;
+    w.velLast = value.velDegSec;
+    acc.posSum += value.posDeg;
+    acc.velSum += value.velDegSec;
+
+    if(w.count < factor)
+    {
+        return;
+    }
+
+    // Single writer per stream. So head is just loaded and stored.
+    uint64_t pos = stream.head.load(std::memory_order_relaxed);
+
+    w.index = pos;
+    w.posMean = acc.posSum / (double)w.count;
+    w.velMean = acc.velSum / (double)w.count;
+
+    // Even sequence 2 * (pos + 1) marks complete window number pos. 0 means never written.
+    _EntryStruct &entry = stream.ring[pos & (_ringSize - 1)];
+
+    entry.seq.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.window = w;
+    entry.seq.store(2 * (pos + 1), std::memory_order_release);
+
+    stream.head.store(pos + 1, std::memory_order_release);
+
+    w.count = 0;
+}
+
+const EAL580B_Decimator::_StreamStruct* EAL580B_Decimator::_stream(uint16_t slot, uint8_t stream) const
+{
+    if( (slot >= _slotNum) || (stream >= _factors.size()) )
+    {
+        return nullptr;
+    }
+
+    return &_streams[slot * _factors.size() + stream];
+}
+
+bool EAL580B_Decimator::read(uint16_t slot, uint8_t stream, uint64_t &cursor, EAL580B_WindowStruct &window) const
+{
+    const _StreamStruct *s = _stream(slot, stream);
+
+    if(s == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t head = s->head.load(std::memory_order_acquire);
+
+    // Skip windows that are already overwritten.
+    if( (head > _ringSize) && (cursor < head - _ringSize) )
+    {
+        cursor = head - _ringSize;
+    }
+
+    while(cursor < head)
+    {
+        const _EntryStruct &entry = s->ring[cursor & (_ringSize - 1)];
+        uint64_t seq = entry.seq.load(std::memory_order_acquire);
+
+        if(seq == 2 * (cursor + 1))
+        {
+            window = entry.window;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if(entry.seq.load(std::memory_order_relaxed) == seq)
+            {
+                cursor++;
+                return true;
+            }
+        }
+
+        // Overwritten while reading.
+        cursor++;
+    }
+
+    return false;
+}
+
+bool EAL580B_Decimator::readLatest(uint16_t slot, uint8_t stream, EAL580B_WindowStruct &window) const
+{
+    uint64_t head = getHead(slot, stream);
+
+    if(head == 0)
+    {
+        return false;
+    }
+
+    uint64_t cursor = head - 1;
+
+    return read(slot, stream, cursor, window);
+}
+
+uint64_t EAL580B_Decimator::getHead(uint16_t slot, uint8_t stream) const
+{
+    const _StreamStruct *s = _stream(slot, stream);
+
+    if(s == nullptr)
+    {
+        return 0;
+    }
+
+    return s->head.load(std::memory_order_acquire);
+}
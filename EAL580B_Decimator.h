@@ -0,0 +1,154 @@
+#ifndef _EAL580B_DECIMATOR_H
+#define _EAL580B_DECIMATOR_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For lock-free window ring
+#include <memory>                   // For unique_ptr
+#include <string>                   // For error message
+#include <vector>                   // For stream and slot arrays
+#include "EAL580B.h"                // EAL580B value struct
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Max number of streams (output rates) of one decimator.
+    #define DECIMATOR_STREAM_MAX            8
+}
+
+// #################################################################################
+
+/// Aggregate of one decimation window of one encoder.
+struct EAL580B_WindowStruct
+{
+    /// Window number in stream. 0 is the first window.
+    uint64_t index;
+
+    /// Host time of first and last sample of window. [ns] (value.timeNs)
+    uint64_t startTimeNs;
+    uint64_t endTimeNs;
+
+    /// Number of samples in window.
+    uint32_t count;
+
+    /// Bitwise or of sample status of all samples in window. SAMPLE_VALID (0) if all samples were valid.
+    uint8_t status;
+
+    /// Position statistic. [deg] (value.posDeg)
+    double posMin;
+    double posMax;
+    double posMean;
+    double posLast;
+
+    /// Speed statistic. [deg/s] (value.velDegSec)
+    double velMin;
+    double velMax;
+    double velMean;
+    double velLast;
+};
+
+// #################################################################################
+/**
+ * @brief Decimating aggregation of encoder samples for low-rate consumers. e.g. HMI and historian.
+ * Each stream closes a window every FACTOR samples and stores min/max/mean/last of position and speed.
+ * Each sample costs O(1) per stream. Closed windows go to a lock-free ring of each slot and stream.
+ * @note Attach to encoders with EAL580B::attachDecimator(). Each slot must be written by only one thread.
+ * Read functions can be used from any thread and never block the writer.
+ */
+class EAL580B_Decimator
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        /// @brief Default constructor.
+        EAL580B_Decimator();
+
+        /**
+         * @brief Allocate slots and streams. Do not use at cycle time.
+         * @param slotNum is number of slots. (one for each encoder)
+         * @param factors is number of samples per window of each stream. e.g. 40 for 4 kHz to 100 Hz.
+         * @param ringSize is number of windows in ring of each stream. Must be power of 2.
+         * @return true if successed.
+         */
+        bool init(uint16_t slotNum, const std::vector<uint32_t> &factors, uint32_t ringSize = 64);
+
+        /// @brief Return number of slots.
+        uint16_t getSlotNum(void) const {return _slotNum;}
+
+        /// @brief Return number of streams.
+        uint8_t getStreamNum(void) const {return (uint8_t)_factors.size();}
+
+        /// @brief Return samples per window of stream.
+        uint32_t getFactor(uint8_t stream) const {return _factors[stream];}
+
+        /**
+         * @brief Add one sample to all streams of slot. Only memory writes.
+         * @return false if slot is out of range.
+         */
+        bool push(uint16_t slot, const EAL580B::ValueStruct &value);
+
+        /**
+         * @brief Read latest closed window of slot and stream.
+         * @return false if no window closed yet or writer is too fast to get a consistent copy.
+         */
+        bool readLatest(uint16_t slot, uint8_t stream, EAL580B_WindowStruct &window) const;
+
+        /**
+         * @brief Read next window of slot and stream after cursor.
+         * @param cursor is reader position. Start with 0 or getHead(). Advanced past read or overwritten windows.
+         * @return false if no new window.
+         */
+        bool read(uint16_t slot, uint8_t stream, uint64_t &cursor, EAL580B_WindowStruct &window) const;
+
+        /// @brief Return number of windows closed in stream of slot.
+        uint64_t getHead(uint16_t slot, uint8_t stream) const;
+
+    private:
+
+        /// Running aggregate of the open window.
+        struct _AccumulatorStruct
+        {
+            EAL580B_WindowStruct window;
+            double posSum;
+            double velSum;
+        };
+
+        /// Seqlock protected window. Sequence is odd while writing.
+        struct alignas(64) _EntryStruct
+        {
+            std::atomic<uint64_t> seq;
+            EAL580B_WindowStruct window;
+        };
+
+        /// Open window and ring of closed windows of one slot and stream.
+        struct _StreamStruct
+        {
+            _AccumulatorStruct acc;
+
+            /// Number of closed windows.
+            std::atomic<uint64_t> head;
+
+            std::unique_ptr<_EntryStruct[]> ring;
+        };
+
+        uint16_t _slotNum;
+        uint32_t _ringSize;
+        std::vector<uint32_t> _factors;
+
+        // Index is slot * stream number + stream.
+        std::unique_ptr<_StreamStruct[]> _streams;
+
+        // Return stream of slot. nullptr if out of range.
+        const _StreamStruct* _stream(uint16_t slot, uint8_t stream) const;
+
+        // Add sample to open window. Close it after factor samples.
+        void _add(_StreamStruct &stream, uint32_t factor, const EAL580B::ValueStruct &value);
+
+        // Start new window with first sample.
+        static void _open(_AccumulatorStruct &acc, const EAL580B::ValueStruct &value);
+};
+
+#endif
@@ -0,0 +1,173 @@
+#include "EAL580B_Diagnostics.h"
+#include "EAL580B_objDict.h"        // Object dictionary of EAL580B
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_Diagnostics::EAL580B_Diagnostics()
+{
+    parameters.CYCLES_PER_SDO = 100;
+    parameters.TIMEOUT_US = EC_TIMEOUTRXM;
+    parameters.TEMPERATURE_MAX = 85;
+    parameters.TEMPERATURE_HYSTERESIS = 5;
+
+    _cycle = 0;
+}
+
+size_t EAL580B_Diagnostics::add(EAL580B* encoder)
+{
+    _SlotStruct slot;
+
+    slot.encoder = encoder;
+    slot.values = {};
+    slot.item = DIAG_ITEM_ERROR_REGISTER;
+    slot.overTemperature = false;
+
+    // Spread first starts of slaves over cycles. So slaves do not use the mailbox in the same cycle.
+    uint32_t period = (parameters.CYCLES_PER_SDO > 0) ? parameters.CYCLES_PER_SDO : 1;
+    slot.startCycle = _cycle + 1 + (_slots.size() % period) - period;
+
+    _slots.push_back(std::move(slot));
+
+    return _slots.size() - 1;
+}
+
+uint64_t EAL580B_Diagnostics::getAgeNs(size_t index, uint8_t item) const
+{
+    if( (index >= _slots.size()) || (item >= DIAG_ITEM_NUM) || (_slots[index].values.timeNs[item] == 0) )
+    {
+        return UINT64_MAX;
+    }
+
+    return EAL580B::nowNs() - _slots[index].values.timeNs[item];
+}
+
+void EAL580B_Diagnostics::step(void)
+{
+    _cycle++;
+
+    for(_SlotStruct &slot : _slots)
+    {
+        // Busy transfer is checked each cycle. It owns the slave mailbox until it is finished.
+        if(slot.transfer.getState() == SDO_TRANSFER_BUSY)
+        {
+            uint8_t state = slot.transfer.poll();
+
+            if(state != SDO_TRANSFER_BUSY)
+            {
+                _finish(slot, state);
+            }
+
+            continue;
+        }
+
+        // One new read of slave per budget period.
+        if(_cycle - slot.startCycle < parameters.CYCLES_PER_SDO)
+        {
+            continue;
+        }
+
+        slot.startCycle = _cycle;
+        _start(slot);
+    }
+}
+
+void EAL580B_Diagnostics::_start(_SlotStruct &slot)
+{
+    uint16_t slave = slot.encoder->parameters.ETHERCAT_ID;
+
+    switch(slot.item)
+    {
+        case DIAG_ITEM_ERROR_REGISTER:
+            slot.transfer.startRead(slave, EAL580B_OD::ErrorRegister::index, EAL580B_OD::ErrorRegister::subindex, parameters.TIMEOUT_US);
+        break;
+        case DIAG_ITEM_TEMPERATURE:
+            slot.transfer.startRead(slave, EAL580B_OD::SensorTemperature::index, EAL580B_OD::SensorTemperature::subindex, parameters.TIMEOUT_US);
+        break;
+        default:
+            slot.transfer.startRead(slave, EAL580B_OD::OffsetValue::index, EAL580B_OD::OffsetValue::subindex, parameters.TIMEOUT_US);
+        break;
+    }
+
+    // Send failure is handled now. The item is retried after the next budget period.
+    // Busy mailbox lock leaves transfer idle. The same item is started after the next budget period.
+    if(slot.transfer.getState() == SDO_TRANSFER_ERROR)
+    {
+        _finish(slot, SDO_TRANSFER_ERROR);
+    }
+}
+
+void EAL580B_Diagnostics::_finish(_SlotStruct &slot, uint8_t state)
+{
+    EAL580B &encoder = *slot.encoder;
+    DiagValueStruct &values = slot.values;
+    const EAL580B_Status &status = slot.transfer.getStatus();
+    uint64_t now = EAL580B::nowNs();
+
+    encoder.metrics.addSdo(false, (state == SDO_TRANSFER_DONE) ? 1 : 0, status.code == EAL580B_ERR_SDO_ABORT, now - slot.transfer.getStartTimeNs());
+
+    uint8_t item = slot.item;
+    slot.item = (uint8_t)((slot.item + 1) % DIAG_ITEM_NUM);
+
+    if(state != SDO_TRANSFER_DONE)
+    {
+        values.failures[item]++;
+        encoder.errors.push({now, encoder.parameters.ETHERCAT_ID, status, "Error Encoder EAL580B: Diagnostic SDO read was not successed."});
+        return;
+    }
+
+    values.timeNs[item] = now;
+
+    switch(item)
+    {
+        case DIAG_ITEM_ERROR_REGISTER:
+        {
+            uint8_t data = 0;
+            slot.transfer.getData(&data, sizeof(data));
+
+            // Event on rising generic error bit.
+            if( ((data & 0x01) != 0) && ((values.errorRegister & 0x01) == 0) )
+            {
+                _event(slot, EAL580B_ERR_DEVICE, EAL580B_OD::ErrorRegister::index, "Error Encoder EAL580B: Generic error bit of error register is set.");
+            }
+
+            values.errorRegister = data;
+        }
+        break;
+        case DIAG_ITEM_TEMPERATURE:
+        {
+            int32_t data = 0;
+            slot.transfer.getData(&data, sizeof(data));
+            values.temperature = data;
+            encoder.metrics.setTemperature(data, now);
+
+            if( !slot.overTemperature && (data > parameters.TEMPERATURE_MAX) )
+            {
+                slot.overTemperature = true;
+                _event(slot, EAL580B_ERR_OVER_TEMPERATURE, EAL580B_OD::SensorTemperature::index, "Error Encoder EAL580B: Sensor temperature is over maximum.");
+            }
+            else if( slot.overTemperature && (data < parameters.TEMPERATURE_MAX - parameters.TEMPERATURE_HYSTERESIS) )
+            {
+                slot.overTemperature = false;
+            }
+        }
+        break;
+        default:
+        {
+            int32_t data = 0;
+            slot.transfer.getData(&data, sizeof(data));
+            values.offsetValue = data;
+        }
+        break;
+    }
+}
+
+void EAL580B_Diagnostics::_event(_SlotStruct &slot, uint8_t code, uint16_t index, const char* message)
+{
+    EAL580B_Status status = {code, 0, index, slot.transfer.getStatus().wkc, 0};
+
+    slot.encoder->errors.push({EAL580B::nowNs(), slot.encoder->parameters.ETHERCAT_ID, status, message});
+}
@@ -0,0 +1,138 @@
+#ifndef _EAL580B_DIAGNOSTICS_H
+#define _EAL580B_DIAGNOSTICS_H
+
+// Header Includes:
+#include <vector>                   // For encoder list
+#include "EAL580B.h"                // EAL580B encoder object
+#include "EAL580B_Mailbox.h"        // Non-blocking SDO transfer
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Diagnostic items. Index in DiagValueStruct arrays:
+    #define DIAG_ITEM_ERROR_REGISTER        0       // Object 0x1001
+    #define DIAG_ITEM_TEMPERATURE           1       // Object 0x2120
+    #define DIAG_ITEM_OFFSET_VALUE          2       // Object 0x6509
+    #define DIAG_ITEM_NUM                   3
+}
+
+// #################################################################################
+/**
+ * @brief Background diagnostic monitor of many encoders.
+ * Error register, sensor temperature and offset value are read round-robin with non-blocking SDO transfers.
+ * Each mailbox operation (request send or one response check) is a short blocking datagram round trip.
+ * Each slave starts at most one read per CYCLES_PER_SDO cycles, and starts of slaves are spread over cycles.
+ * A busy read is checked each cycle, so it owns the slave mailbox only until its response arrives.
+ * Threshold events are pushed to the encoder error ring. (EAL580B::errors)
+ * @note Call step() once per cycle. In the process data thread keep the cycle time well above the datagram
+ * time of all busy reads. Blocking SDO functions of a monitored encoder wait while its diagnostic read is busy.
+ * (see isBusy())
+ */
+class EAL580B_Diagnostics
+{
+    public:
+
+        struct ParameterStruct
+        {
+            /// Minimum number of cycles between two read starts of one slave. Default: 100
+            uint32_t CYCLES_PER_SDO;
+
+            /// Response timeout of one diagnostic SDO. [us] Default: EC_TIMEOUTRXM
+            int TIMEOUT_US;
+
+            /// Over-temperature event threshold. [degC] Default: 85
+            int32_t TEMPERATURE_MAX;
+
+            /// Temperature must drop this amount below TEMPERATURE_MAX before a new over-temperature event. [degC] Default: 5
+            int32_t TEMPERATURE_HYSTERESIS;
+
+        }parameters;
+
+        /// Latest diagnostic values of one encoder.
+        struct DiagValueStruct
+        {
+            /// Error register. (0x1001) Bit 0: generic error.
+            uint8_t errorRegister;
+
+            /// Sensor temperature. (0x2120) [degC]
+            int32_t temperature;
+
+            /// Preset offset value. (0x6509) [step]
+            int32_t offsetValue;
+
+            /// Steady clock time of last successful read of each item. [ns] 0 means never read.
+            uint64_t timeNs[DIAG_ITEM_NUM];
+
+            /// Number of failed reads of each item.
+            uint32_t failures[DIAG_ITEM_NUM];
+        };
+
+        /// @brief Default constructor. Init parameters.
+        EAL580B_Diagnostics();
+
+        /**
+         * @brief Add encoder to monitor. Do not use at cycle time.
+         * @return Index of encoder in monitor.
+         */
+        size_t add(EAL580B* encoder);
+
+        /// @brief Remove all encoders.
+        void clear(void) {_slots.clear(); _cycle = 0;}
+
+        /// @brief Return number of monitored encoders.
+        size_t size(void) const {return _slots.size();}
+
+        /**
+         * @brief Progress diagnostic transfers of slaves in their budget. No waiting for responses.
+         * A busy transfer of each slave is checked once. A slave without busy transfer starts the next read
+         * in its budget.
+         * Finished values are stored and thresholds are checked.
+         */
+        void step(void);
+
+        /// @brief Return latest diagnostic values of encoder by index.
+        const DiagValueStruct& getValues(size_t index) const {return _slots[index].values;}
+
+        /**
+         * @brief Return age of an item value. [ns]
+         * @param item is DIAG_ITEM_xxx.
+         * @return UINT64_MAX if item was never read.
+         */
+        uint64_t getAgeNs(size_t index, uint8_t item) const;
+
+        /// @brief Return true if a diagnostic transfer of encoder is busy.
+        bool isBusy(size_t index) const {return _slots[index].transfer.getState() == SDO_TRANSFER_BUSY;}
+
+    private:
+
+        struct _SlotStruct
+        {
+            EAL580B *encoder;
+            EAL580B_SdoTransfer transfer;
+            DiagValueStruct values;
+
+            /// Item of busy or next transfer.
+            uint8_t item;
+
+            /// Cycle of last read start.
+            uint64_t startCycle;
+
+            bool overTemperature;
+        };
+
+        std::vector<_SlotStruct> _slots;
+
+        uint64_t _cycle;
+
+        // Start read of current item of slot.
+        void _start(_SlotStruct &slot);
+
+        // Handle finished transfer of slot.
+        void _finish(_SlotStruct &slot, uint8_t state);
+
+        // Push a diagnostic event to encoder error ring.
+        void _event(_SlotStruct &slot, uint8_t code, uint16_t index, const char* message);
+};
+
+#endif
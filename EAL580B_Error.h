@@ -0,0 +1,196 @@
+#ifndef _EAL580B_ERROR_H
+#define _EAL580B_ERROR_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For lock-free ring
+#include "EAL580B_Clock.h"          // Shared host time base
+
+// #################################################################################
+
+/// Error codes of EAL580B_Status.
+enum EAL580B_ErrorCode : uint8_t
+{
+    EAL580B_OK = 0,
+
+    /// Parameters or function arguments are not correct.
+    EAL580B_ERR_PARAMETER,
+
+    /// Slave is not in the required ethercat state.
+    EAL580B_ERR_STATE,
+
+    /// SDO read got no response. (working counter <= 0 and no abort code)
+    EAL580B_ERR_SDO_READ,
+
+    /// SDO write got no response. (working counter <= 0 and no abort code)
+    EAL580B_ERR_SDO_WRITE,
+
+    /// SDO transfer aborted by slave. See abortCode.
+    EAL580B_ERR_SDO_ABORT,
+
+    /// Requested object is not in the TxPDO mapping.
+    EAL580B_ERR_PDO_NOT_MAPPED,
+
+    /// TxPDO mapping is not correct.
+    EAL580B_ERR_MAPPING,
+
+    /// SDO response size does not match the object type.
+    EAL580B_ERR_SDO_SIZE,
+
+    /// Device reports an error in error register. (0x1001)
+    EAL580B_ERR_DEVICE,
+
+    /// Sensor temperature is over the configured maximum.
+    EAL580B_ERR_OVER_TEMPERATURE,
+
+    /// Synchronization mode is not supported or read back value is not the written value.
+    EAL580B_ERR_SYNC,
+
+    /// Identity (0x1018) of slave is not the identity read in init(). Another device is connected.
+    EAL580B_ERR_IDENTITY,
+
+    /// SDO transfer was not started. Slave did not respond to the last transfers. (open SDO breaker)
+    EAL580B_ERR_SDO_BREAKER,
+
+    /// SDO transfer was not started. Another transfer of the slave used the mailbox too long.
+    EAL580B_ERR_MAILBOX_BUSY,
+};
+
+// #################################################################################
+/**
+ * @brief Result of an encoder operation. Plain value type. No heap memory.
+ */
+struct EAL580B_Status
+{
+    /// EAL580B_ErrorCode value.
+    uint8_t code;
+
+    /// CoE object subindex of failed SDO transfer.
+    uint8_t subindex;
+
+    /// CoE object index of failed SDO transfer.
+    uint16_t index;
+
+    /// Working counter of SDO transfer.
+    int wkc;
+
+    /// SDO abort code from slave. 0 if no abort.
+    uint32_t abortCode;
+
+    /// @brief Return true if successed.
+    bool ok(void) const {return code == EAL580B_OK;}
+};
+
+// #################################################################################
+/**
+ * @brief Fixed-size lock-free ring of recent error events.
+ * Many threads can push. Readers never block writers, old events are overwritten.
+ * @note No heap memory. Safe to use from the real-time thread.
+ */
+class EAL580B_ErrorRing
+{
+    public:
+
+        /// Number of events kept. Must be power of 2.
+        static const uint32_t SIZE = 32;
+
+        struct EventStruct
+        {
+            /// Steady clock time of event. [ns]
+            uint64_t timeNs;
+
+            /// Ethercat slave id.
+            int slaveId;
+
+            EAL580B_Status status;
+
+            /// Static error message. (string literal)
+            const char* message;
+        };
+
+        EAL580B_ErrorRing() : _head(0)
+        {
+            for(uint32_t i = 0; i < SIZE; i++)
+            {
+                _slots[i].seq.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Push an event. Overwrite oldest event if ring is full.
+         */
+        void push(const EventStruct &event)
+        {
+            uint64_t pos = _head.fetch_add(1, std::memory_order_relaxed);
+            _SlotStruct &slot = _slots[pos & (SIZE - 1)];
+
+            // Odd sequence while writing. Readers retry or skip this slot.
+            slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.event = event;
+            slot.seq.store(2 * pos + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Read next event after cursor.
+         * @param cursor is reader position. Start with 0. It is advanced past read or overwritten events.
+         * @param event is read event.
+         * @return false if no new event.
+         */
+        bool read(uint64_t &cursor, EventStruct &event) const
+        {
+            uint64_t head = _head.load(std::memory_order_acquire);
+
+            // Skip events that are already overwritten.
+            if(head > SIZE && cursor < head - SIZE)
+            {
+                cursor = head - SIZE;
+            }
+
+            while(cursor < head)
+            {
+                const _SlotStruct &slot = _slots[cursor & (SIZE - 1)];
+
+                uint64_t seq1 = slot.seq.load(std::memory_order_acquire);
+                event = slot.event;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t seq2 = slot.seq.load(std::memory_order_relaxed);
+
+                if( (seq1 == seq2) && (seq1 == 2 * cursor + 2) )
+                {
+                    cursor++;
+                    return true;
+                }
+
+                if(seq1 < 2 * cursor + 2)
+                {
+                    // Writer of this event did not finish yet.
+                    return false;
+                }
+
+                // Overwritten while reading.
+                cursor++;
+            }
+
+            return false;
+        }
+
+        /// @brief Return total number of pushed events.
+        uint64_t getCount(void) const {return _head.load(std::memory_order_relaxed);}
+
+        /// @brief Return steady clock time now. [ns]
+        static uint64_t nowNs(void) {return EAL580B_nowNs();}
+
+    private:
+
+        struct _SlotStruct
+        {
+            std::atomic<uint64_t> seq;
+            EventStruct event;
+        };
+
+        std::atomic<uint64_t> _head;
+        _SlotStruct _slots[SIZE];
+};
+
+#endif
@@ -0,0 +1,241 @@
+#include "EAL580B_Failover.h"
+#include "EAL580B_objDict.h"        // Object dictionary of EAL580B
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_Failover::EAL580B_Failover()
+{
+    parameters.POLL_PERIOD_US = 10000;
+    parameters.MAX_AGE_US = 100000;
+    parameters.RECOVER_SAMPLES = 10;
+    parameters.TIMEOUT_US = 50000;
+
+    _running.store(false, std::memory_order_relaxed);
+}
+
+EAL580B_Failover::~EAL580B_Failover()
+{
+    stop();
+}
+
+size_t EAL580B_Failover::add(EAL580B* encoder)
+{
+    std::unique_ptr<_SlotStruct> slot(new _SlotStruct);
+
+    slot->encoder = encoder;
+    slot->active.store(false, std::memory_order_relaxed);
+    slot->seq.store(0, std::memory_order_relaxed);
+    slot->polled = {0, 0, 0, 0, 0};
+    slot->pollNs = 0;
+    slot->entered.store(0, std::memory_order_relaxed);
+    slot->exited.store(0, std::memory_order_relaxed);
+    slot->polls.store(0, std::memory_order_relaxed);
+    slot->failures.store(0, std::memory_order_relaxed);
+    slot->lastError.store(EAL580B_OK, std::memory_order_relaxed);
+    slot->lastAbortCode.store(0, std::memory_order_relaxed);
+
+    _slots.push_back(std::move(slot));
+
+    encoder->attachFailover(this, (uint16_t)(_slots.size() - 1));
+
+    return _slots.size() - 1;
+}
+
+bool EAL580B_Failover::start(void)
+{
+    if(_running.load(std::memory_order_relaxed))
+    {
+        errorMessage = "Error Failover: start() polling thread is already running.";
+        return false;
+    }
+
+    if(_slots.empty())
+    {
+        errorMessage = "Error Failover: start() no encoder is added.";
+        return false;
+    }
+
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread(&EAL580B_Failover::_run, this);
+
+    return true;
+}
+
+void EAL580B_Failover::stop(void)
+{
+    _running.store(false, std::memory_order_release);
+
+    if(_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+EAL580B_Failover::CounterStruct EAL580B_Failover::getCounters(size_t index) const
+{
+    const _SlotStruct &slot = *_slots[index];
+
+    return {slot.entered.load(std::memory_order_relaxed), slot.exited.load(std::memory_order_relaxed),
+            slot.polls.load(std::memory_order_relaxed), slot.failures.load(std::memory_order_relaxed),
+            slot.lastError.load(std::memory_order_relaxed), slot.lastAbortCode.load(std::memory_order_relaxed)};
+}
+
+void EAL580B_Failover::_run(void)
+{
+    const uint64_t periodNs = (uint64_t)parameters.POLL_PERIOD_US * 1000;
+
+    while(_running.load(std::memory_order_acquire))
+    {
+        uint64_t now = EAL580B::nowNs();
+        uint64_t waitNs = periodNs;
+
+        for(std::unique_ptr<_SlotStruct> &slot : _slots)
+        {
+            if(!slot->active.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            uint64_t dueNs = slot->pollNs + periodNs;
+
+            if(now >= dueNs)
+            {
+                _poll(*slot);
+                now = EAL580B::nowNs();
+                dueNs = slot->pollNs + periodNs;
+            }
+
+            waitNs = (dueNs > now) && (dueNs - now < waitNs) ? (dueNs - now) : waitNs;
+        }
+
+        // Sleep until next due poll. Idle thread checks for new degraded encoders once per period.
+        std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+    }
+}
+
+void EAL580B_Failover::_poll(_SlotStruct &slot)
+{
+    const uint8_t *mapped = slot.encoder->_TxMapFlag;
+    _PolledStruct polled = {0, 0, 0, 0, 0};
+    uint8_t state = SDO_TRANSFER_DONE;
+    uint64_t startNs = EAL580B::nowNs();
+
+    slot.pollNs = startNs;
+
+    // Only the objects decoded from process data are read. (_TxMapFlag indexes)
+    if(mapped[4] != 0)
+    {
+        state = _readObject(slot, EAL580B_OD::PositionValue::index, EAL580B_OD::PositionValue::subindex, &polled.posStep, sizeof(polled.posStep));
+    }
+
+    if( (state == SDO_TRANSFER_DONE) && (mapped[5] != 0) )
+    {
+        state = _readObject(slot, EAL580B_OD::PositionRawValue::index, EAL580B_OD::PositionRawValue::subindex, &polled.posRawStep, sizeof(polled.posRawStep));
+    }
+
+    if( (state == SDO_TRANSFER_DONE) && (mapped[1] != 0) )
+    {
+        state = _readObject(slot, EAL580B_OD::PositionValue2Bytes::index, EAL580B_OD::PositionValue2Bytes::subindex, &polled.pos2BytesStep, sizeof(polled.pos2BytesStep));
+    }
+
+    if( (state == SDO_TRANSFER_DONE) && (mapped[2] != 0) )
+    {
+        state = _readObject(slot, EAL580B_OD::SpeedValue4Bytes::index, EAL580B_OD::SpeedValue4Bytes::subindex, &polled.velStep, sizeof(polled.velStep));
+    }
+
+    if(state == SDO_TRANSFER_IDLE)
+    {
+        // Mailbox is used by another user. Not a failure of the slave. Poll again after the period.
+        return;
+    }
+
+    if(state != SDO_TRANSFER_DONE)
+    {
+        const EAL580B_Status &status = slot.transfer.getStatus();
+
+        slot.lastError.store(status.code, std::memory_order_relaxed);
+        slot.lastAbortCode.store(status.abortCode, std::memory_order_relaxed);
+        slot.failures.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    polled.timeNs = startNs + (EAL580B::nowNs() - startNs) / 2;
+
+    // Single writer. Sequence counts polls.
+    uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.polled = polled;
+    slot.seq.store(seq + 2, std::memory_order_release);
+
+    slot.polls.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint8_t EAL580B_Failover::_readObject(_SlotStruct &slot, uint16_t index, uint8_t subindex, void* data, int size)
+{
+    if(!slot.transfer.startRead(slot.encoder->parameters.ETHERCAT_ID, index, subindex, (int)parameters.TIMEOUT_US))
+    {
+        return slot.transfer.getState();
+    }
+
+    uint8_t state;
+
+    while((state = slot.transfer.poll()) == SDO_TRANSFER_BUSY)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(_MAILBOX_CHECK_US));
+    }
+
+    if(state == SDO_TRANSFER_DONE)
+    {
+        slot.transfer.getData(data, size);
+    }
+
+    return state;
+}
+
+void EAL580B_Failover::_setActive(size_t index, bool active)
+{
+    _SlotStruct &slot = *_slots[index];
+
+    slot.active.store(active, std::memory_order_release);
+
+    if(active)
+    {
+        slot.entered.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        slot.exited.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool EAL580B_Failover::_read(size_t index, _PolledStruct &polled) const
+{
+    const _SlotStruct &slot = *_slots[index];
+
+    // Writer needs one SDO transfer for each write. A few retries are enough.
+    for(int i = 0; i < 4; i++)
+    {
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+
+        if(seq == 0)
+        {
+            return false;
+        }
+
+        polled = slot.polled;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if( ((seq & 1) == 0) && (slot.seq.load(std::memory_order_relaxed) == seq) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,162 @@
+#ifndef _EAL580B_FAILOVER_H
+#define _EAL580B_FAILOVER_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For lock-free polled sample
+#include <memory>                   // For unique_ptr
+#include <string>                   // For error message
+#include <thread>                   // For polling thread
+#include <vector>                   // For slot list
+#include "EAL580B.h"                // EAL580B encoder object
+#include "EAL580B_Mailbox.h"        // Non-blocking SDO transfer
+
+// #################################################################################
+/**
+ * @brief PDO to SDO failover of many encoders.
+ * When process data of an encoder is not valid (SAMPLE_STALE_WKC, SAMPLE_NOT_OP or SAMPLE_FROZEN), a background
+ * thread polls the mapped position and speed objects of that encoder with SDO, not faster than POLL_PERIOD_US.
+ * The PDO decode of the encoder takes each new polled sample once and marks it SAMPLE_DEGRADED. Without a new
+ * polled sample, the last values are held with SAMPLE_DEGRADED | SAMPLE_HELD. After RECOVER_SAMPLES consecutive
+ * valid PDO samples, polling stops.
+ * Polls use own SDO transfers with own timeout and status. Encoder state and its SDO timing are not touched.
+ * A poll is skipped if another mailbox user of the slave owns the mailbox lock.
+ * @note Add encoders before start(). The decode thread only reads the polled sample and never waits for the mailbox.
+ */
+class EAL580B_Failover
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        struct ParameterStruct
+        {
+            /// Minimum time between two SDO polls of one encoder. [us] Default: 10000
+            uint32_t POLL_PERIOD_US;
+
+            /// Polled sample older than this is not used. Last good value is held instead. [us] Default: 100000
+            uint32_t MAX_AGE_US;
+
+            /// Number of consecutive valid PDO samples to leave degraded mode. Default: 10
+            uint32_t RECOVER_SAMPLES;
+
+            /// Maximum time for the response of one poll SDO transfer. [us] Default: 50000
+            uint32_t TIMEOUT_US;
+
+        }parameters;
+
+        /// Failover counters of one encoder.
+        struct CounterStruct
+        {
+            /// Number of entries to degraded mode.
+            uint32_t entered;
+
+            /// Number of returns to PDO mode.
+            uint32_t exited;
+
+            /// Number of successful and failed SDO polls.
+            uint64_t polls;
+            uint64_t failures;
+
+            /// EAL580B_ErrorCode and SDO abort code of last failed poll.
+            uint8_t lastError;
+            uint32_t lastAbortCode;
+        };
+
+        /// @brief Default constructor. Init parameters.
+        EAL580B_Failover();
+
+        /// @brief Destructor. Stop polling thread.
+        ~EAL580B_Failover();
+
+        /**
+         * @brief Add encoder and attach failover to it. Do not use after start().
+         * @return Index of encoder in failover.
+         */
+        size_t add(EAL580B* encoder);
+
+        /// @brief Return number of encoders.
+        size_t size(void) const {return _slots.size();}
+
+        /**
+         * @brief Start polling thread.
+         * @return false if already started or no encoder is added.
+         */
+        bool start(void);
+
+        /// @brief Stop polling thread. Wait for the running poll.
+        void stop(void);
+
+        /// @brief Return true if encoder by index is in degraded mode.
+        bool isDegraded(size_t index) const {return _slots[index]->active.load(std::memory_order_relaxed);}
+
+        /// @brief Return counters of encoder by index. Poll counters are written by polling thread.
+        CounterStruct getCounters(size_t index) const;
+
+    private:
+
+        friend class EAL580B;
+
+        /// Sample polled with SDO.
+        struct _PolledStruct
+        {
+            /// Host time at middle of SDO transfers. [ns]
+            uint64_t timeNs;
+            uint32_t posStep;
+            uint32_t posRawStep;
+            uint16_t pos2BytesStep;
+            int32_t velStep;
+        };
+
+        struct _SlotStruct
+        {
+            EAL580B *encoder;
+
+            /// Degraded mode request of decode thread.
+            std::atomic<bool> active;
+
+            /// Seqlock protected polled sample. Sequence is odd while writing.
+            std::atomic<uint64_t> seq;
+            _PolledStruct polled;
+
+            /// Host time of last poll. Polling thread only. [ns]
+            uint64_t pollNs;
+
+            /// SDO transfer of polling thread.
+            EAL580B_SdoTransfer transfer;
+
+            std::atomic<uint32_t> entered;
+            std::atomic<uint32_t> exited;
+            std::atomic<uint64_t> polls;
+            std::atomic<uint64_t> failures;
+            std::atomic<uint8_t> lastError;
+            std::atomic<uint32_t> lastAbortCode;
+        };
+
+        // Check interval of a busy poll transfer. [us]
+        static const uint32_t _MAILBOX_CHECK_US = 100;
+
+        std::vector<std::unique_ptr<_SlotStruct>> _slots;
+
+        std::thread _thread;
+        std::atomic<bool> _running;
+
+        // Polling loop of background thread.
+        void _run(void);
+
+        // Read mapped position and speed objects of slot with SDO and store polled sample.
+        void _poll(_SlotStruct &slot);
+
+        // Read one object with the transfer of slot. Wait for the response.
+        // Return SDO_TRANSFER_DONE, SDO_TRANSFER_ERROR or SDO_TRANSFER_IDLE if the mailbox lock is busy.
+        uint8_t _readObject(_SlotStruct &slot, uint16_t index, uint8_t subindex, void* data, int size);
+
+        // Enter or leave degraded mode of slot. Used by decode thread.
+        void _setActive(size_t index, bool active);
+
+        // Copy latest polled sample of slot. Return false if no sample or writer is too fast.
+        bool _read(size_t index, _PolledStruct &polled) const;
+};
+
+#endif
@@ -0,0 +1,407 @@
+#include "EAL580B_FilterBank.h"
+#include <cmath>                    // For filter design
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_FilterBank::EAL580B_FilterBank()
+{
+    parameters.SAMPLE_TIME_US = 1000;
+
+    _accPrimed = false;
+}
+
+size_t EAL580B_FilterBank::add(EAL580B* encoder, const FilterStruct &vel, const FilterStruct &acc)
+{
+    _encoders.push_back(encoder);
+    _velFilters.push_back(vel);
+    _accFilters.push_back(acc);
+
+    return _encoders.size() - 1;
+}
+
+void EAL580B_FilterBank::clear(void)
+{
+    _encoders.clear();
+    _velFilters.clear();
+    _accFilters.clear();
+    _blocks.clear();
+    _vel.clear();
+    _velFilt.clear();
+    _velPrev.clear();
+    _acc.clear();
+    _accFilt.clear();
+    _timePrev.clear();
+}
+
+bool EAL580B_FilterBank::_checkFilter(const FilterStruct &filter)
+{
+    double nyquist = 0.5e6 / (double)parameters.SAMPLE_TIME_US;
+
+    switch(filter.type)
+    {
+        case FILTER_NONE:
+            return true;
+        case FILTER_IIR1:
+        case FILTER_IIR2:
+            return (filter.cutoffHz > 0) && (filter.cutoffHz < nyquist);
+        case FILTER_MOVING_AVERAGE:
+            return (filter.window >= 1) && (filter.window <= FILTER_WINDOW_MAX);
+        case FILTER_MEDIAN:
+            return (filter.window >= 1) && (filter.window <= FILTER_WINDOW_MAX) && ((filter.window % 2) == 1);
+        default:
+            return false;
+    }
+}
+
+bool EAL580B_FilterBank::build(void)
+{
+    if(parameters.SAMPLE_TIME_US == 0)
+    {
+        errorMessage = "Error Encoder EAL580B: EAL580B_FilterBank::build() was not successed. SAMPLE_TIME_US is 0.";
+        return false;
+    }
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        if(!_checkFilter(_velFilters[i]) || !_checkFilter(_accFilters[i]))
+        {
+            errorMessage = "Error Encoder EAL580B: EAL580B_FilterBank::build() was not successed. Filter of encoder " + std::to_string(i) + " is not correct.";
+            return false;
+        }
+    }
+
+    _blocks.clear();
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        _addLane(_SIGNAL_VEL, _velFilters[i], i);
+        _addLane(_SIGNAL_ACC, _accFilters[i], i);
+    }
+
+    for(_BlockStruct &block : _blocks)
+    {
+        size_t lanes = block.encoders.size();
+
+        block.in.assign(lanes, 0);
+        block.out.assign(lanes, 0);
+        block.z1.assign(lanes, 0);
+        block.z2.assign(lanes, 0);
+        block.sum.assign(lanes, 0);
+        block.history.assign((size_t)block.window * lanes, 0);
+        block.work.assign((block.type == FILTER_MEDIAN) ? (size_t)block.window * lanes : 0, 0);
+    }
+
+    size_t num = _encoders.size();
+
+    _vel.assign(num, 0);
+    _velFilt.assign(num, 0);
+    _velPrev.assign(num, 0);
+    _acc.assign(num, 0);
+    _accFilt.assign(num, 0);
+    _timePrev.assign(num, 0);
+
+    reset();
+
+    return true;
+}
+
+void EAL580B_FilterBank::_addLane(uint8_t signal, const FilterStruct &filter, size_t encoder)
+{
+    // IIR1 and IIR2 are both biquads with lane coefficients. So they share blocks.
+    uint8_t type = (filter.type == FILTER_IIR1) ? FILTER_IIR2 : filter.type;
+    uint8_t window = ((type == FILTER_MOVING_AVERAGE) || (type == FILTER_MEDIAN)) ? filter.window : 0;
+
+    _BlockStruct* found = nullptr;
+
+    for(_BlockStruct &block : _blocks)
+    {
+        if( (block.signal == signal) && (block.type == type) && (block.window == window) )
+        {
+            found = &block;
+            break;
+        }
+    }
+
+    if(found == nullptr)
+    {
+        _blocks.push_back(_BlockStruct());
+        found = &_blocks.back();
+        found->signal = signal;
+        found->type = type;
+        found->window = window;
+        found->row = 0;
+        found->primed = false;
+    }
+
+    found->encoders.push_back(encoder);
+    found->b0.push_back(1);
+    found->b1.push_back(0);
+    found->b2.push_back(0);
+    found->a1.push_back(0);
+    found->a2.push_back(0);
+
+    if(type == FILTER_IIR2)
+    {
+        _designIIR(*found, found->encoders.size() - 1, filter);
+    }
+}
+
+void EAL580B_FilterBank::_designIIR(_BlockStruct &block, size_t lane, const FilterStruct &filter)
+{
+    double T = (double)parameters.SAMPLE_TIME_US * 1e-6;
+
+    if(filter.type == FILTER_IIR1)
+    {
+        // y = y + alpha * (x - y)
+        double alpha = 1.0 - exp(-2.0 * M_PI * filter.cutoffHz * T);
+
+        block.b0[lane] = alpha;
+        block.a1[lane] = alpha - 1.0;
+        return;
+    }
+
+    // Butterworth low-pass by bilinear transform.
+    double K = tan(M_PI * filter.cutoffHz * T);
+    double Q = 1.0 / sqrt(2.0);
+    double norm = 1.0 / (1.0 + K / Q + K * K);
+
+    block.b0[lane] = K * K * norm;
+    block.b1[lane] = 2.0 * block.b0[lane];
+    block.b2[lane] = block.b0[lane];
+    block.a1[lane] = 2.0 * (K * K - 1.0) * norm;
+    block.a2[lane] = (1.0 - K / Q + K * K) * norm;
+}
+
+void EAL580B_FilterBank::reset(void)
+{
+    for(_BlockStruct &block : _blocks)
+    {
+        block.primed = false;
+        block.row = 0;
+    }
+
+    _accPrimed = false;
+}
+
+void EAL580B_FilterBank::update(void)
+{
+    const size_t num = _encoders.size();
+
+    for(size_t i = 0; i < num; i++)
+    {
+        _vel[i] = _encoders[i]->value.velDegSec;
+    }
+
+    _runSignal(_SIGNAL_VEL, _vel, _velFilt);
+
+    double defaultDt = (double)parameters.SAMPLE_TIME_US * 1e-6;
+
+    for(size_t i = 0; i < num; i++)
+    {
+        uint64_t timeNs = _encoders[i]->value.timeNs;
+        double dt = (_accPrimed && (timeNs > _timePrev[i])) ? (double)(timeNs - _timePrev[i]) * 1e-9 : defaultDt;
+
+        _acc[i] = _accPrimed ? (_velFilt[i] - _velPrev[i]) / dt : 0.0;
+        _velPrev[i] = _velFilt[i];
+        _timePrev[i] = timeNs;
+    }
+
+    _accPrimed = true;
+
+    _runSignal(_SIGNAL_ACC, _acc, _accFilt);
+
+    for(size_t i = 0; i < num; i++)
+    {
+        _encoders[i]->value.velFiltDegSec = _velFilt[i];
+        _encoders[i]->value.accDegSec2 = _accFilt[i];
+    }
+}
+
+void EAL580B_FilterBank::_runSignal(uint8_t signal, const std::vector<double> &input, std::vector<double> &output)
+{
+    for(_BlockStruct &block : _blocks)
+    {
+        if(block.signal != signal)
+        {
+            continue;
+        }
+
+        const size_t lanes = block.encoders.size();
+
+        for(size_t k = 0; k < lanes; k++)
+        {
+            block.in[k] = input[block.encoders[k]];
+        }
+
+        _step(block);
+
+        for(size_t k = 0; k < lanes; k++)
+        {
+            output[block.encoders[k]] = block.out[k];
+        }
+    }
+}
+
+void EAL580B_FilterBank::_step(_BlockStruct &block)
+{
+    if(!block.primed)
+    {
+        _prime(block);
+        block.primed = true;
+    }
+
+    switch(block.type)
+    {
+        case FILTER_IIR2:
+            _stepIIR(block);
+        break;
+        case FILTER_MOVING_AVERAGE:
+            _stepMovingAverage(block);
+        break;
+        case FILTER_MEDIAN:
+            _stepMedian(block);
+        break;
+        default:
+            block.out = block.in;
+        break;
+    }
+}
+
+void EAL580B_FilterBank::_prime(_BlockStruct &block)
+{
+    const size_t lanes = block.encoders.size();
+    const double* x = block.in.data();
+
+    // Steady state of biquad with unity DC gain for constant input x.
+    for(size_t k = 0; k < lanes; k++)
+    {
+        block.z2[k] = (block.b2[k] - block.a2[k]) * x[k];
+        block.z1[k] = (block.b1[k] - block.a1[k]) * x[k] + block.z2[k];
+        block.sum[k] = (double)block.window * x[k];
+    }
+
+    for(uint32_t r = 0; r < block.window; r++)
+    {
+        double* h = block.history.data() + r * lanes;
+
+        for(size_t k = 0; k < lanes; k++)
+        {
+            h[k] = x[k];
+        }
+    }
+
+    block.row = 0;
+}
+
+void EAL580B_FilterBank::_stepIIR(_BlockStruct &block)
+{
+    const size_t lanes = block.encoders.size();
+    const double* x = block.in.data();
+    const double* b0 = block.b0.data();
+    const double* b1 = block.b1.data();
+    const double* b2 = block.b2.data();
+    const double* a1 = block.a1.data();
+    const double* a2 = block.a2.data();
+    double* z1 = block.z1.data();
+    double* z2 = block.z2.data();
+    double* y = block.out.data();
+
+    // Transposed direct form II.
+    for(size_t k = 0; k < lanes; k++)
+    {
+        double out = b0[k] * x[k] + z1[k];
+        z1[k] = b1[k] * x[k] - a1[k] * out + z2[k];
+        z2[k] = b2[k] * x[k] - a2[k] * out;
+        y[k] = out;
+    }
+}
+
+void EAL580B_FilterBank::_stepMovingAverage(_BlockStruct &block)
+{
+    const size_t lanes = block.encoders.size();
+    const double* x = block.in.data();
+    double* h = block.history.data() + block.row * lanes;
+    double* sum = block.sum.data();
+    double* y = block.out.data();
+    const double scale = 1.0 / (double)block.window;
+
+    // Oldest sample is in the row that is overwritten.
+    for(size_t k = 0; k < lanes; k++)
+    {
+        sum[k] += x[k] - h[k];
+        h[k] = x[k];
+        y[k] = sum[k] * scale;
+    }
+
+    block.row = (block.row + 1) % block.window;
+
+    // Sum again from history once per window, so rounding errors of running sum do not grow.
+    if(block.row == 0)
+    {
+        for(size_t k = 0; k < lanes; k++)
+        {
+            sum[k] = 0;
+        }
+
+        for(uint32_t r = 0; r < block.window; r++)
+        {
+            const double* hr = block.history.data() + r * lanes;
+
+            for(size_t k = 0; k < lanes; k++)
+            {
+                sum[k] += hr[k];
+            }
+        }
+    }
+}
+
+void EAL580B_FilterBank::_stepMedian(_BlockStruct &block)
+{
+    const size_t lanes = block.encoders.size();
+    const uint32_t window = block.window;
+    const double* x = block.in.data();
+    double* h = block.history.data() + block.row * lanes;
+    double* w = block.work.data();
+
+    for(size_t k = 0; k < lanes; k++)
+    {
+        h[k] = x[k];
+    }
+
+    block.row = (block.row + 1) % window;
+
+    for(size_t i = 0; i < (size_t)window * lanes; i++)
+    {
+        w[i] = block.history[i];
+    }
+
+    // Odd-even transposition sort of each lane. Compare-exchange of two rows is branch-free min/max over lanes.
+    for(uint32_t pass = 0; pass < window; pass++)
+    {
+        for(uint32_t r = pass % 2; r + 1 < window; r += 2)
+        {
+            double* lo = w + r * lanes;
+            double* hi = lo + lanes;
+
+            for(size_t k = 0; k < lanes; k++)
+            {
+                double a = lo[k];
+                double b = hi[k];
+                lo[k] = (a < b) ? a : b;
+                hi[k] = (a < b) ? b : a;
+            }
+        }
+    }
+
+    const double* median = w + (window / 2) * lanes;
+    double* y = block.out.data();
+
+    for(size_t k = 0; k < lanes; k++)
+    {
+        y[k] = median[k];
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef _EAL580B_FILTERBANK_H
+#define _EAL580B_FILTERBANK_H
+
+// Header Includes:
+#include <vector>                   // For structure-of-arrays state
+#include "EAL580B.h"                // EAL580B encoder object
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Filter types of FilterStruct::type:
+    #define FILTER_NONE                     0       // Output is input.
+    #define FILTER_IIR1                     1       // First order low-pass. cutoffHz
+    #define FILTER_IIR2                     2       // Second order Butterworth low-pass. cutoffHz
+    #define FILTER_MOVING_AVERAGE           3       // Mean of last window samples.
+    #define FILTER_MEDIAN                   4       // Median of last window samples. window must be odd.
+
+    // Max window of moving average and median filters.
+    #define FILTER_WINDOW_MAX               32
+}
+
+// #################################################################################
+/**
+ * @brief Speed and acceleration filter bank of many encoders.
+ * Each encoder has a filter for value.velDegSec and a filter for acceleration derived from filtered speed.
+ * Results are written to value.velFiltDegSec and value.accDegSec2 of each encoder.
+ * Encoders with the same filter configuration share one block. State of a block is stored structure-of-arrays
+ * across encoders, so each filter step is one loop over contiguous arrays that the compiler vectorizes.
+ * @note Add encoders and call build() before cyclic update(). Call update() after encoder values are updated.
+ */
+class EAL580B_FilterBank
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        struct ParameterStruct
+        {
+            /// Update period. Used for IIR design and as acceleration time step if sample times do not advance. [us] Default: 1000
+            uint32_t SAMPLE_TIME_US;
+
+        }parameters;
+
+        /// Filter configuration of one signal.
+        struct FilterStruct
+        {
+            /// FILTER_xxx.
+            uint8_t type;
+
+            /// Cutoff frequency of IIR filters. [Hz] It must be less than half of sample rate.
+            double cutoffHz;
+
+            /// Window length of moving average and median filters. 1 to FILTER_WINDOW_MAX.
+            uint8_t window;
+        };
+
+        /// @brief Default constructor. Init parameters.
+        EAL580B_FilterBank();
+
+        /**
+         * @brief Add encoder to bank. Do not use at cycle time.
+         * @param vel is filter of speed.
+         * @param acc is filter of acceleration.
+         * @return Index of encoder in bank.
+         */
+        size_t add(EAL580B* encoder, const FilterStruct &vel, const FilterStruct &acc);
+
+        /// @brief Remove all encoders and blocks.
+        void clear(void);
+
+        /// @brief Return number of encoders.
+        size_t size(void) const {return _encoders.size();}
+
+        /**
+         * @brief Check filter configurations and create blocks. Filter states are reset.
+         * @return true if successed.
+         */
+        bool build(void);
+
+        /// @brief Reset filter states. First update after reset fills filters with its input.
+        void reset(void);
+
+        /**
+         * @brief Filter speed and acceleration of all encoders once.
+         * @note Use in process data thread after encoder values are updated.
+         */
+        void update(void);
+
+    private:
+
+        // Signals of a block:
+        static const uint8_t _SIGNAL_VEL = 0;
+        static const uint8_t _SIGNAL_ACC = 1;
+
+        /// Filter state of all encoders with the same configuration. Index is lane.
+        struct _BlockStruct
+        {
+            uint8_t signal;
+            uint8_t type;
+            uint8_t window;
+
+            /// Encoder index of each lane.
+            std::vector<size_t> encoders;
+
+            std::vector<double> in;
+            std::vector<double> out;
+
+            /// Biquad coefficients and transposed direct form II state. IIR1 uses b1 = b2 = a2 = 0.
+            std::vector<double> b0, b1, b2, a1, a2;
+            std::vector<double> z1, z2;
+
+            /// History of window filters. Row-major [window][lanes].
+            std::vector<double> history;
+            std::vector<double> sum;
+
+            /// Sort buffer of median filter. Row-major [window][lanes].
+            std::vector<double> work;
+
+            /// Next history row.
+            uint32_t row;
+
+            bool primed;
+        };
+
+        std::vector<EAL580B*> _encoders;
+        std::vector<FilterStruct> _velFilters;
+        std::vector<FilterStruct> _accFilters;
+
+        std::vector<_BlockStruct> _blocks;
+
+        // Per encoder signals and state for acceleration. Index is encoder index.
+        std::vector<double> _vel;
+        std::vector<double> _velFilt;
+        std::vector<double> _velPrev;
+        std::vector<double> _acc;
+        std::vector<double> _accFilt;
+        std::vector<uint64_t> _timePrev;
+        bool _accPrimed;
+
+        // Check one filter configuration.
+        bool _checkFilter(const FilterStruct &filter);
+
+        // Add encoder lane to the block of its configuration.
+        void _addLane(uint8_t signal, const FilterStruct &filter, size_t encoder);
+
+        // Set IIR coefficients of lane from filter configuration.
+        void _designIIR(_BlockStruct &block, size_t lane, const FilterStruct &filter);
+
+        // Filter block inputs to outputs.
+        void _step(_BlockStruct &block);
+        void _stepIIR(_BlockStruct &block);
+        void _stepMovingAverage(_BlockStruct &block);
+        void _stepMedian(_BlockStruct &block);
+
+        // Fill filter state so output is input.
+        void _prime(_BlockStruct &block);
+
+        // Run all blocks of signal.
+        void _runSignal(uint8_t signal, const std::vector<double> &input, std::vector<double> &output);
+};
+
+#endif
@@ -0,0 +1,316 @@
+#include "EAL580B_History.h"
+
+// #######################################################################
+
+EAL580B_History::EAL580B_History()
+{
+    parameters.RANGE_DEG = 0;
+
+    _capacity = 0;
+    _head.store(0, std::memory_order_relaxed);
+    _lastTimeNs = 0;
+}
+
+bool EAL580B_History::init(uint32_t capacity)
+{
+    if( (capacity < 2) || ((capacity & (capacity - 1)) != 0) )
+    {
+        errorMessage = "Error History: init() capacity is not correct.";
+        return false;
+    }
+
+    _ring.reset(new _EntryStruct[capacity]);
+    _capacity = capacity;
+
+    clear();
+
+    return true;
+}
+
+void EAL580B_History::clear(void)
+{
+    for(uint32_t i = 0; i < _capacity; i++)
+    {
+        _ring[i].seq.store(0, std::memory_order_relaxed);
+    }
+
+    _head.store(0, std::memory_order_release);
+    _lastTimeNs = 0;
+}
+
+bool EAL580B_History::push(uint64_t timeNs, double posDeg, double velDegSec, uint8_t status)
+{
+    if(_capacity == 0)
+    {
+        return false;
+    }
+
+    // Single writer. So head is just loaded and stored.
+    uint64_t pos = _head.load(std::memory_order_relaxed);
+
+    // Binary search needs strictly increasing times.
+    if( (pos > 0) && (timeNs <= _lastTimeNs) )
+    {
+        timeNs = _lastTimeNs + 1;
+    }
+
+    _EntryStruct &entry = _ring[pos & (_capacity - 1)];
+
+    // Even sequence 2 * (pos + 1) marks complete sample number pos.
+    entry.seq.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.data = {timeNs, posDeg, velDegSec, status};
+    entry.seq.store(2 * (pos + 1), std::memory_order_release);
+
+    _head.store(pos + 1, std::memory_order_release);
+    _lastTimeNs = timeNs;
+
+    return true;
+}
+
+bool EAL580B_History::_read(uint64_t index, _DataStruct &data) const
+{
+    const _EntryStruct &entry = _ring[index & (_capacity - 1)];
+    uint64_t seq = entry.seq.load(std::memory_order_acquire);
+
+    if(seq != 2 * (index + 1))
+    {
+        return false;
+    }
+
+    data = entry.data;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return entry.seq.load(std::memory_order_relaxed) == seq;
+}
+
+int EAL580B_History::_find(uint64_t timeNs, uint64_t lo, uint64_t hi, uint64_t hint, uint64_t &index) const
+{
+    _DataStruct data;
+
+    if(!_read(lo, data))
+    {
+        return -1;
+    }
+
+    if(timeNs < data.timeNs)
+    {
+        return 0;
+    }
+
+    if(!_read(hi - 1, data))
+    {
+        return -1;
+    }
+
+    if(timeNs > data.timeNs)
+    {
+        return 0;
+    }
+
+    // Invariant: time(a) <= timeNs. All samples after b are later than timeNs.
+    uint64_t a = lo;
+    uint64_t b = hi - 1;
+
+    // Exponential search forward from hint of previous ascending query.
+    if( (hint > lo) && (hint < hi) )
+    {
+        if(!_read(hint, data))
+        {
+            return -1;
+        }
+
+        if(data.timeNs <= timeNs)
+        {
+            a = hint;
+            uint64_t step = 1;
+
+            while(a + step <= b)
+            {
+                if(!_read(a + step, data))
+                {
+                    return -1;
+                }
+
+                if(data.timeNs > timeNs)
+                {
+                    b = a + step - 1;
+                    break;
+                }
+
+                a += step;
+                step *= 2;
+            }
+        }
+    }
+
+    while(a < b)
+    {
+        uint64_t mid = a + (b - a + 1) / 2;
+
+        if(!_read(mid, data))
+        {
+            return -1;
+        }
+
+        if(data.timeNs <= timeNs)
+        {
+            a = mid;
+        }
+        else
+        {
+            b = mid - 1;
+        }
+    }
+
+    index = a;
+
+    return 1;
+}
+
+bool EAL580B_History::_interpolate(uint64_t timeNs, uint64_t index, uint64_t hi, SampleStruct &sample) const
+{
+    _DataStruct d0;
+
+    if(!_read(index, d0))
+    {
+        return false;
+    }
+
+    sample.timeNs = timeNs;
+    sample.found = 1;
+
+    if( (d0.timeNs == timeNs) || (index + 1 >= hi) )
+    {
+        sample.posDeg = d0.posDeg;
+        sample.velDegSec = d0.velDegSec;
+        sample.status = d0.status;
+        return true;
+    }
+
+    _DataStruct d1;
+
+    if(!_read(index + 1, d1))
+    {
+        return false;
+    }
+
+    double f = (double)(timeNs - d0.timeNs) / (double)(d1.timeNs - d0.timeNs);
+    double dp = d1.posDeg - d0.posDeg;
+    double range = parameters.RANGE_DEG;
+
+    if(range > 0)
+    {
+        dp = (dp > 0.5 * range) ? (dp - range) : ((dp < -0.5 * range) ? (dp + range) : dp);
+    }
+
+    double pos = d0.posDeg + f * dp;
+
+    if(range > 0)
+    {
+        pos = (pos >= range) ? (pos - range) : ((pos < 0) ? (pos + range) : pos);
+    }
+
+    sample.posDeg = pos;
+    sample.velDegSec = d0.velDegSec + f * (d1.velDegSec - d0.velDegSec);
+    sample.status = d0.status | d1.status;
+
+    return true;
+}
+
+bool EAL580B_History::_query(uint64_t timeNs, uint64_t &hint, SampleStruct &sample) const
+{
+    sample.timeNs = timeNs;
+    sample.found = 0;
+
+    if(_capacity == 0)
+    {
+        return false;
+    }
+
+    // Writer can overwrite the oldest samples during search. Then search again in the new range.
+    for(int i = 0; i < 3; i++)
+    {
+        uint64_t hi = _head.load(std::memory_order_acquire);
+
+        if(hi == 0)
+        {
+            return false;
+        }
+
+        // Oldest slot is skipped. Writer overwrites it with the next sample.
+        uint64_t lo = (hi >= _capacity) ? (hi - _capacity + 1) : 0;
+        uint64_t index = 0;
+        int state = _find(timeNs, lo, hi, hint, index);
+
+        if(state == 0)
+        {
+            return false;
+        }
+
+        if( (state == 1) && _interpolate(timeNs, index, hi, sample) )
+        {
+            hint = index;
+            return true;
+        }
+    }
+
+    sample.found = 0;
+
+    return false;
+}
+
+bool EAL580B_History::query(uint64_t timeNs, SampleStruct &sample) const
+{
+    uint64_t hint = 0;
+
+    return _query(timeNs, hint, sample);
+}
+
+size_t EAL580B_History::queryBatch(const uint64_t* times, size_t num, SampleStruct* samples) const
+{
+    size_t found = 0;
+    uint64_t hint = 0;
+
+    for(size_t i = 0; i < num; i++)
+    {
+        // Hint is used only for ascending times.
+        if( (i > 0) && (times[i] < times[i - 1]) )
+        {
+            hint = 0;
+        }
+
+        if(_query(times[i], hint, samples[i]))
+        {
+            found++;
+        }
+    }
+
+    return found;
+}
+
+uint64_t EAL580B_History::getOldestTimeNs(void) const
+{
+    uint64_t hi = _head.load(std::memory_order_acquire);
+    _DataStruct data;
+
+    if( (hi == 0) || !_read((hi >= _capacity) ? (hi - _capacity + 1) : 0, data) )
+    {
+        return 0;
+    }
+
+    return data.timeNs;
+}
+
+uint64_t EAL580B_History::getNewestTimeNs(void) const
+{
+    uint64_t hi = _head.load(std::memory_order_acquire);
+    _DataStruct data;
+
+    if( (hi == 0) || !_read(hi - 1, data) )
+    {
+        return 0;
+    }
+
+    return data.timeNs;
+}
@@ -0,0 +1,138 @@
+#ifndef _EAL580B_HISTORY_H
+#define _EAL580B_HISTORY_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For lock-free ring
+#include <memory>                   // For unique_ptr
+#include <string>                   // For error message
+
+// #################################################################################
+/**
+ * @brief Time-indexed position history of one encoder.
+ * Fixed capacity ring of samples keyed by sampling instant in host time. (EAL580B::nowNs() time base)
+ * Position and velocity at any time inside the ring are interpolated linearly between the two nearest samples.
+ * Lookup is a binary search. (O(log n)) Batch lookup of ascending times continues from the previous result.
+ * @note Attach to one encoder with EAL580B::attachHistory(). Single writer. Queries can be used from any thread
+ * and never block the writer. e.g. 4096 samples keep one second of a 4 kHz bus.
+ */
+class EAL580B_History
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        struct ParameterStruct
+        {
+            /**
+             * @brief Position range where posDeg wraps to 0. [deg] Interpolation takes the short way over the wrap.
+             * @note Value 0 means position does not wrap. The default value is 0.
+             */
+            double RANGE_DEG;
+
+        }parameters;
+
+        /// Interpolated history sample.
+        struct SampleStruct
+        {
+            /// Query time. [ns]
+            uint64_t timeNs;
+
+            double posDeg;
+            double velDegSec;
+
+            /// Bitwise or of status of the two samples around query time.
+            uint8_t status;
+
+            /// 1 if time is inside history. Otherwise other fields are not valid.
+            uint8_t found;
+        };
+
+        /// @brief Default constructor. Init parameters.
+        EAL580B_History();
+
+        /**
+         * @brief Allocate ring. Do not use at cycle time.
+         * @param capacity is number of samples. Must be power of 2.
+         * @return true if successed.
+         */
+        bool init(uint32_t capacity);
+
+        /// @brief Remove all samples. Do not use while writer or readers are running.
+        void clear(void);
+
+        /// @brief Return capacity of ring.
+        uint32_t getCapacity(void) const {return _capacity;}
+
+        /**
+         * @brief Append one sample. Only memory writes.
+         * @param timeNs is sampling instant. It must increase. Otherwise it is moved 1 ns after previous sample.
+         * @return false if not initialized.
+         */
+        bool push(uint64_t timeNs, double posDeg, double velDegSec, uint8_t status);
+
+        /**
+         * @brief Return interpolated sample at a time.
+         * @return false if time is not inside history.
+         */
+        bool query(uint64_t timeNs, SampleStruct &sample) const;
+
+        /**
+         * @brief Return interpolated samples at many times.
+         * Ascending times are found by a forward search from the previous result. Cost is near O(log n + num).
+         * @param times is array of query times. [ns]
+         * @param num is number of times.
+         * @param samples is output array of num samples. found is 0 for times not inside history.
+         * @return Number of found samples.
+         */
+        size_t queryBatch(const uint64_t* times, size_t num, SampleStruct* samples) const;
+
+        /// @brief Return sampling instant of oldest and newest sample. [ns] 0 if history is empty.
+        uint64_t getOldestTimeNs(void) const;
+        uint64_t getNewestTimeNs(void) const;
+
+    private:
+
+        /// Sample data of one entry.
+        struct _DataStruct
+        {
+            uint64_t timeNs;
+            double posDeg;
+            double velDegSec;
+            uint8_t status;
+        };
+
+        /// Seqlock protected sample. Sequence is odd while writing.
+        struct _EntryStruct
+        {
+            std::atomic<uint64_t> seq;
+            _DataStruct data;
+        };
+
+        std::unique_ptr<_EntryStruct[]> _ring;
+        uint32_t _capacity;
+
+        /// Number of written samples.
+        std::atomic<uint64_t> _head;
+
+        /// Time of last written sample. Writer only.
+        uint64_t _lastTimeNs;
+
+        // Copy entry of sample number index. Return false if it is overwritten or being written.
+        bool _read(uint64_t index, _DataStruct &data) const;
+
+        /**
+         * @brief Find last sample at or before time in [lo, hi). Start from hint by exponential search if hint is valid.
+         * @return 1 found, 0 not inside history, -1 ring was overwritten during search.
+         */
+        int _find(uint64_t timeNs, uint64_t lo, uint64_t hi, uint64_t hint, uint64_t &index) const;
+
+        // Interpolate at time between sample index and the next one.
+        bool _interpolate(uint64_t timeNs, uint64_t index, uint64_t hi, SampleStruct &sample) const;
+
+        // One lookup with retries. hint is updated to found index.
+        bool _query(uint64_t timeNs, uint64_t &hint, SampleStruct &sample) const;
+};
+
+#endif
@@ -0,0 +1,277 @@
+#include "EAL580B_Mailbox.h"
+#include <cstring>                  // For memcpy
+#include <thread>                   // For sleep_for
+#include <chrono>                   // For microseconds
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+// CoE SDO mailbox frame. Same layout as SOEM internal ec_SDOt.
+#pragma pack(push, 1)
+struct _SdoFrameStruct
+{
+    ec_mbxheadert MbxHeader;
+    uint16 CANOpen;
+    uint8 Command;
+    uint16 Index;
+    uint8 SubIndex;
+    uint32 ldata;
+};
+#pragma pack(pop)
+
+// #######################################################################
+
+std::atomic<bool> EAL580B_MailboxOwner::_busy[EC_MAXSLAVE] = {};
+
+EAL580B_MailboxOwner& EAL580B_MailboxOwner::operator=(EAL580B_MailboxOwner &&other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        _slave = other._slave;
+        _owned = other._owned;
+        other._owned = false;
+    }
+
+    return *this;
+}
+
+bool EAL580B_MailboxOwner::tryAcquire(uint16_t slave)
+{
+    release();
+
+    bool expected = false;
+
+    if(!_busy[slave].compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    _slave = slave;
+    _owned = true;
+
+    return true;
+}
+
+bool EAL580B_MailboxOwner::acquire(uint16_t slave, uint32_t timeoutUs)
+{
+    uint64_t deadlineNs = EAL580B_nowNs() + (uint64_t)timeoutUs * 1000;
+
+    while(!tryAcquire(slave))
+    {
+        if(EAL580B_nowNs() >= deadlineNs)
+        {
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(_WAIT_STEP_US));
+    }
+
+    return true;
+}
+
+void EAL580B_MailboxOwner::release(void)
+{
+    if(_owned)
+    {
+        _busy[_slave].store(false, std::memory_order_release);
+        _owned = false;
+    }
+}
+
+// #######################################################################
+
+EAL580B_SdoTransfer::EAL580B_SdoTransfer()
+{
+    _state = SDO_TRANSFER_IDLE;
+    _write = false;
+    _slave = 0;
+    _index = 0;
+    _subindex = 0;
+    _data = 0;
+    _dataSize = 0;
+    _startNs = 0;
+    _deadlineNs = 0;
+    _status = {EAL580B_OK, 0, 0, 0, 0};
+}
+
+bool EAL580B_SdoTransfer::startRead(uint16_t slave, uint16_t index, uint8_t subindex, int timeoutUs)
+{
+    _write = false;
+    _slave = slave;
+    _index = index;
+    _subindex = subindex;
+    _data = 0;
+    _dataSize = 0;
+
+    ec_clearmbx(&_mbxOut);
+    _SdoFrameStruct *frame = (_SdoFrameStruct*)&_mbxOut;
+
+    frame->MbxHeader.length = htoes(0x000a);
+    frame->MbxHeader.address = htoes(0x0000);
+    frame->MbxHeader.priority = 0x00;
+    frame->CANOpen = htoes(0x000 + (ECT_COES_SDOREQ << 12));
+    frame->Command = ECT_SDO_UP_REQ;
+    frame->Index = htoes(index);
+    frame->SubIndex = subindex;
+    frame->ldata = 0;
+
+    return _send(timeoutUs);
+}
+
+bool EAL580B_SdoTransfer::startWrite(uint16_t slave, uint16_t index, uint8_t subindex, const void* data, int size, int timeoutUs)
+{
+    _write = true;
+    _slave = slave;
+    _index = index;
+    _subindex = subindex;
+    _data = 0;
+    _dataSize = 0;
+
+    if( (size < 1) || (size > 4) )
+    {
+        _fail(EAL580B_ERR_PARAMETER, 0);
+        return false;
+    }
+
+    ec_clearmbx(&_mbxOut);
+    _SdoFrameStruct *frame = (_SdoFrameStruct*)&_mbxOut;
+
+    frame->MbxHeader.length = htoes(0x000a);
+    frame->MbxHeader.address = htoes(0x0000);
+    frame->MbxHeader.priority = 0x00;
+    frame->CANOpen = htoes(0x000 + (ECT_COES_SDOREQ << 12));
+    frame->Command = ECT_SDO_DOWN_EXP | (((4 - size) << 2) & 0x0c);
+    frame->Index = htoes(index);
+    frame->SubIndex = subindex;
+
+    uint32_t value = 0;
+    memcpy(&value, data, size);
+    frame->ldata = htoel(value);
+
+    return _send(timeoutUs);
+}
+
+bool EAL580B_SdoTransfer::_send(int timeoutUs)
+{
+    _SdoFrameStruct *frame = (_SdoFrameStruct*)&_mbxOut;
+
+    // Start of a busy transfer abandons it and releases its mailbox first.
+    if(!_owner.tryAcquire(_slave))
+    {
+        // Mailbox is used by another transfer. Nothing is sent.
+        _state = SDO_TRANSFER_IDLE;
+        return false;
+    }
+
+    // Mailbox counter of slave. Same handling as SOEM SDO functions.
+    uint8 cnt = ec_nextmbxcnt(ec_slave[_slave].mbx_cnt);
+    ec_slave[_slave].mbx_cnt = cnt;
+    frame->MbxHeader.mbxtype = ECT_MBXT_COE + (uint8)(cnt << 4);
+
+    _startNs = EAL580B_ErrorRing::nowNs();
+    _deadlineNs = _startNs + (uint64_t)timeoutUs * 1000;
+    _status = {EAL580B_OK, _subindex, _index, 0, 0};
+
+    // Empty slave mailbox from old responses. Without waiting.
+    ec_clearmbx(&_mbxIn);
+    ec_mbxreceive(_slave, &_mbxIn, 0);
+
+    if(ec_mbxsend(_slave, &_mbxOut, EC_TIMEOUTTXM) <= 0)
+    {
+        _fail(_write ? EAL580B_ERR_SDO_WRITE : EAL580B_ERR_SDO_READ, 0);
+        return false;
+    }
+
+    _state = SDO_TRANSFER_BUSY;
+
+    return true;
+}
+
+uint8_t EAL580B_SdoTransfer::_fail(uint8_t code, uint32_t abortCode)
+{
+    _status = {code, _subindex, _index, 0, abortCode};
+    _state = SDO_TRANSFER_ERROR;
+
+    _owner.release();
+
+    return _state;
+}
+
+uint8_t EAL580B_SdoTransfer::poll(void)
+{
+    if(_state != SDO_TRANSFER_BUSY)
+    {
+        return _state;
+    }
+
+    ec_clearmbx(&_mbxIn);
+    int wkc = ec_mbxreceive(_slave, &_mbxIn, 0);
+
+    if(wkc <= 0)
+    {
+        if(EAL580B_ErrorRing::nowNs() > _deadlineNs)
+        {
+            return _fail(_write ? EAL580B_ERR_SDO_WRITE : EAL580B_ERR_SDO_READ, 0);
+        }
+
+        return _state;
+    }
+
+    const _SdoFrameStruct *frame = (const _SdoFrameStruct*)&_mbxIn;
+
+    if((frame->MbxHeader.mbxtype & 0x0f) != ECT_MBXT_COE)
+    {
+        // Not a CoE response. Keep waiting for our response.
+        return _state;
+    }
+
+    uint16_t service = etohs(frame->CANOpen) >> 12;
+    bool match = (etohs(frame->Index) == _index) && (frame->SubIndex == _subindex);
+
+    // Abort is an SDO request of slave for this object. Same check as SOEM. Emergency or late abort of an
+    // other object is not an abort of this transfer.
+    if( (service == ECT_COES_SDOREQ) && (frame->Command == ECT_SDO_ABORT) && match )
+    {
+        return _fail(EAL580B_ERR_SDO_ABORT, etohl(frame->ldata));
+    }
+
+    if( (service != ECT_COES_SDORES) || !match )
+    {
+        return _state;
+    }
+
+    if(_write == false)
+    {
+        // Only expedited upload is supported. Bit 1 of command is expedited flag.
+        if((frame->Command & 0x02) == 0)
+        {
+            return _fail(EAL580B_ERR_SDO_READ, 0);
+        }
+
+        _data = etohl(frame->ldata);
+        _dataSize = ((frame->Command & 0x01) != 0) ? 4 - ((frame->Command >> 2) & 0x03) : 4;
+    }
+
+    _status.wkc = wkc;
+    _state = SDO_TRANSFER_DONE;
+    _owner.release();
+
+    return _state;
+}
+
+int EAL580B_SdoTransfer::getData(void* data, int size) const
+{
+    if(_state != SDO_TRANSFER_DONE)
+    {
+        return 0;
+    }
+
+    int num = (size < _dataSize) ? size : _dataSize;
+    memcpy(data, &_data, num);
+
+    return num;
+}
@@ -0,0 +1,160 @@
+#ifndef _EAL580B_MAILBOX_H
+#define _EAL580B_MAILBOX_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For mailbox owner flag of slave
+#include "ethercat.h"               // EtherCAT functionality
+#include "EAL580B_Error.h"          // Status result
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Non-blocking SDO transfer states:
+    #define SDO_TRANSFER_IDLE               0x00
+    #define SDO_TRANSFER_BUSY               0x01
+    #define SDO_TRANSFER_DONE               0x02
+    #define SDO_TRANSFER_ERROR              0x03
+}
+
+// #################################################################################
+/**
+ * @brief Ownership of the mailbox of one slave. All mailbox users of a slave in all threads take it,
+ * so a response of one user is not received and lost by another user.
+ * Ownership is a flag, not a lock of a thread. It can be released in any thread and moved between objects.
+ * A second acquire for an owned mailbox in the same thread fails at timeout. It never blocks forever.
+ */
+class EAL580B_MailboxOwner
+{
+    public:
+
+        /// @brief Default constructor. Nothing is owned.
+        EAL580B_MailboxOwner() : _slave(0), _owned(false) {}
+
+        /// @brief Destructor. Release owned mailbox.
+        ~EAL580B_MailboxOwner() {release();}
+
+        EAL580B_MailboxOwner(const EAL580B_MailboxOwner&) = delete;
+        EAL580B_MailboxOwner& operator=(const EAL580B_MailboxOwner&) = delete;
+
+        /// @brief Move ownership.
+        EAL580B_MailboxOwner(EAL580B_MailboxOwner &&other) noexcept : _slave(other._slave), _owned(other._owned) {other._owned = false;}
+
+        /// @brief Move ownership. Owned mailbox of this object is released.
+        EAL580B_MailboxOwner& operator=(EAL580B_MailboxOwner &&other) noexcept;
+
+        /**
+         * @brief Take mailbox of slave without waiting. Owned mailbox of this object is released first.
+         * @return false if another owner has it.
+         */
+        bool tryAcquire(uint16_t slave);
+
+        /**
+         * @brief Take mailbox of slave. Wait for the other owner up to timeoutUs. [us]
+         * @return false if another owner has it after timeoutUs.
+         */
+        bool acquire(uint16_t slave, uint32_t timeoutUs);
+
+        /// @brief Release owned mailbox. Nothing happens if nothing is owned.
+        void release(void);
+
+        /// @brief Return true if a mailbox is owned.
+        bool owns(void) const {return _owned;}
+
+    private:
+
+        // Owner flag of each slave mailbox.
+        static std::atomic<bool> _busy[EC_MAXSLAVE];
+
+        // Check interval while waiting for the other owner. [us]
+        static const uint32_t _WAIT_STEP_US = 50;
+
+        uint16_t _slave;
+        bool _owned;
+};
+
+// #################################################################################
+/**
+ * @brief Non-blocking expedited SDO transfer. (object data size 1 to 4 bytes)
+ * Request is sent by start functions and each poll() checks the mailbox once without waiting.
+ * So many transfers on different slaves can progress together on one thread.
+ * A transfer owns the mailbox of its slave from start until it is finished. Start fails without sending
+ * and the state stays SDO_TRANSFER_IDLE if another user owns the mailbox. Then start again later.
+ * @note Blocking SDO access must own the mailbox too. (see EAL580B_MailboxOwner)
+ */
+class EAL580B_SdoTransfer
+{
+    public:
+
+        /// @brief Default constructor.
+        EAL580B_SdoTransfer();
+
+        /**
+         * @brief Start SDO upload (read) request.
+         * @param timeoutUs is maximum time for response. [us]
+         * @return true if request was sent.
+         */
+        bool startRead(uint16_t slave, uint16_t index, uint8_t subindex, int timeoutUs = EC_TIMEOUTRXM);
+
+        /**
+         * @brief Start SDO expedited download (write) request.
+         * @param size is data size in bytes. 1 to 4.
+         * @param timeoutUs is maximum time for response. [us]
+         * @return true if request was sent.
+         */
+        bool startWrite(uint16_t slave, uint16_t index, uint8_t subindex, const void* data, int size, int timeoutUs = EC_TIMEOUTRXM);
+
+        /**
+         * @brief Check mailbox once for response. No waiting.
+         * @return SDO_TRANSFER_BUSY, SDO_TRANSFER_DONE or SDO_TRANSFER_ERROR.
+         */
+        uint8_t poll(void);
+
+        /// @brief Return transfer state.
+        uint8_t getState(void) const {return _state;}
+
+        /// @brief Return status of finished transfer. abortCode is set if slave aborted transfer.
+        const EAL580B_Status& getStatus(void) const {return _status;}
+
+        /**
+         * @brief Copy uploaded data of finished read transfer.
+         * @param size is size of data buffer. Maximum 4.
+         * @return Number of copied bytes.
+         */
+        int getData(void* data, int size) const;
+
+        /// @brief Return host steady clock time when transfer was started. [ns]
+        uint64_t getStartTimeNs(void) const {return _startNs;}
+
+    private:
+
+        // Mailbox of slave. Owned while transfer is busy.
+        EAL580B_MailboxOwner _owner;
+
+        uint8_t _state;
+        bool _write;
+
+        uint16_t _slave;
+        uint16_t _index;
+        uint8_t _subindex;
+
+        uint32_t _data;
+        int _dataSize;
+
+        uint64_t _startNs;
+        uint64_t _deadlineNs;
+
+        EAL580B_Status _status;
+
+        ec_mbxbuft _mbxOut;
+        ec_mbxbuft _mbxIn;
+
+        // Send prepared request in _mbxOut.
+        bool _send(int timeoutUs);
+
+        // Finish transfer with error code.
+        uint8_t _fail(uint8_t code, uint32_t abortCode);
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "EAL580B_Manager.h"
+#include "EAL580B_objDict.h"        // Object dictionary for EAL580B encoders
+#include "EAL580B_Mailbox.h"        // Mailbox ownership of slave
+#include "EAL580B_Async.h"          // Asynchronous init of all encoders
+#include <cstring>                  // For string functions
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_Manager::EAL580B_Manager()
+{
+    parameters.VENDOR_ID = BAUMER_VENDOR_ID;
+    parameters.PRODUCT_CODE = 0;
+    parameters.DEVICE_NAME = "EAL580";
+    parameters.ENCODER = EAL580B().parameters;
+}
+
+bool EAL580B_Manager::_isEncoder(uint16_t slave)
+{
+    if( (parameters.VENDOR_ID != 0) && (ec_slave[slave].eep_man != parameters.VENDOR_ID) )
+    {
+        return false;
+    }
+
+    if(parameters.PRODUCT_CODE != 0)
+    {
+        return ec_slave[slave].eep_id == parameters.PRODUCT_CODE;
+    }
+
+    // Name from slave information first. It needs no mailbox access.
+    if(strstr(ec_slave[slave].name, parameters.DEVICE_NAME.c_str()) != nullptr)
+    {
+        return true;
+    }
+
+    if((ec_slave[slave].mbx_proto & ECT_MBXPROT_COE) == 0)
+    {
+        return false;
+    }
+
+    char name[EC_MAXNAME + 1] = {0};
+    int size = EC_MAXNAME;
+    EAL580B_MailboxOwner mailbox;
+
+    if(!mailbox.acquire(slave, EC_TIMEOUTRXM))
+    {
+        return false;
+    }
+
+    int wkc = ec_SDOread(slave, Index_DeviceName, 0, FALSE, &size, name, EC_TIMEOUTRXM);
+
+    if(wkc <= 0)
+    {
+        return false;
+    }
+
+    return strstr(name, parameters.DEVICE_NAME.c_str()) != nullptr;
+}
+
+int EAL580B_Manager::scan(void)
+{
+    _encoders.clear();
+
+    for(int slave = 1; slave <= ec_slavecount; slave++)
+    {
+        if(!_isEncoder((uint16_t)slave))
+        {
+            continue;
+        }
+
+        std::unique_ptr<EAL580B> encoder(new EAL580B());
+
+        encoder->parameters = parameters.ENCODER;
+        encoder->parameters.ETHERCAT_ID = slave;
+
+        _encoders.push_back(std::move(encoder));
+    }
+
+    if(_encoders.size() == 0)
+    {
+        errorMessage = "Error Encoder Manager: No EAL580B encoder found.";
+    }
+
+    return (int)_encoders.size();
+}
+
+bool EAL580B_Manager::setup(void)
+{
+    if(_encoders.size() == 0)
+    {
+        errorMessage = "Error Encoder Manager: setup() no encoder to setup.";
+        return false;
+    }
+
+    // Read state of all slaves once. SOEM state and error list are not thread safe, so all inits run on one thread.
+    ec_readstate();
+
+    EAL580B_Scheduler scheduler;
+
+    // Mailbox exchanges of different slaves overlap. So total time is near the slowest single encoder.
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        scheduler.spawn(EAL580B_Async::init(scheduler, *_encoders[i], false));
+    }
+
+    if(!scheduler.run())
+    {
+        errorMessage = "Error Encoder Manager: setup() was not successed for one or some encoders.";
+        return false;
+    }
+
+    return true;
+}
+
+EAL580B* EAL580B_Manager::findBySlaveId(int id)
+{
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        if(_encoders[i]->parameters.ETHERCAT_ID == id)
+        {
+            return _encoders[i].get();
+        }
+    }
+
+    return nullptr;
+}
+
+void EAL580B_Manager::updateValuesPDO(void)
+{
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        _encoders[i]->updateValuesPDO();
+    }
+}
+
+void EAL580B_Manager::updateValuesPDO(int wkc)
+{
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        _encoders[i]->updateValuesPDO(wkc);
+    }
+}
+
+bool EAL580B_Manager::captureInputs(uint64_t cycle, int wkc)
+{
+    bool state = true;
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        state = _encoders[i]->captureInputs(cycle, wkc) && state;
+    }
+
+    return state;
+}
+
+size_t EAL580B_Manager::updateValuesSnapshot(void)
+{
+    size_t num = 0;
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        if(_encoders[i]->updateValuesSnapshot())
+        {
+            num++;
+        }
+    }
+
+    return num;
+}
+
+size_t EAL580B_Manager::recover(void)
+{
+    size_t num = 0;
+
+    ec_readstate();
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        uint8_t state = _encoders[i]->recover();
+
+        if( (state == RECOVERY_BUSY) || (state == RECOVERY_FAILED) )
+        {
+            num++;
+        }
+    }
+
+    return num;
+}
+
+bool EAL580B_Manager::verifyTxPDO(void)
+{
+    bool state = true;
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        if(!_encoders[i]->verifyTxPDO())
+        {
+            errorMessage = _encoders[i]->errorMessage;
+            state = false;
+        }
+    }
+
+    return state;
+}
+
+void EAL580B_Manager::registerMetrics(EAL580B_MetricsRegistry &registry)
+{
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        registry.add(_encoders[i]->parameters.ETHERCAT_ID, &_encoders[i]->metrics);
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef _EAL580B_MANAGER_H
+#define _EAL580B_MANAGER_H
+
+// Header Includes:
+#include <vector>                   // For encoder collection
+#include <memory>                   // For unique_ptr
+#include "EAL580B.h"                // EAL580B encoder object
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Baumer vendor id in EtherCAT slave information.
+    #define BAUMER_VENDOR_ID                0x00000516
+}
+
+// #################################################################################
+/**
+ * @brief Encoder manager. Discover all EAL580B slaves on the bus and set them up together.
+ * @note Use after ethercat configSlaves() (slaves in PRE_OP) and before configMap().
+ */
+class EAL580B_Manager
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        struct ParameterStruct
+        {
+            /**
+             * @brief Vendor id for slave matching. Default is BAUMER_VENDOR_ID.
+             * @note Value 0 means any vendor. Then slaves are matched just by device name.
+             */
+            uint32_t VENDOR_ID;
+
+            /**
+             * @brief Product code for slave matching.
+             * @note Value 0 means any product code. Then slaves of the vendor are matched by device name.
+             */
+            uint32_t PRODUCT_CODE;
+
+            /**
+             * @brief Part of device name (object 0x1008) for slave matching. Default is "EAL580".
+             */
+            std::string DEVICE_NAME;
+
+            /**
+             * @brief Encoder parameters applied to all discovered encoders. ETHERCAT_ID is set by manager.
+             */
+            EAL580B::ParameterStruct ENCODER;
+
+        }parameters;
+
+        /// @brief Default constructor. Init parameters.
+        EAL580B_Manager();
+
+        /**
+         * @brief Scan ec_slave[] and create one encoder object for each matched slave.
+         * Previous encoder objects are removed.
+         * @return Number of found encoders.
+         */
+        int scan(void);
+
+        /**
+         * @brief Init all encoders concurrently with EAL580B_Async::init() on one EAL580B_Scheduler.
+         * @note Commissioning time is near that of a single encoder. Compile with -std=c++20. (EAL580B_Async.h)
+         * @return true if all encoders successed. errorMessage of failed encoders stay in each object.
+         */
+        bool setup(void);
+
+        /// @brief Return number of encoders.
+        size_t size(void) const {return _encoders.size();}
+
+        /// @brief Return encoder by index. Index order is ethercat slave order.
+        EAL580B& operator[](size_t index) {return *_encoders[index];}
+
+        /**
+         * @brief Return encoder by ethercat slave id.
+         * @return nullptr if no encoder with that id.
+         */
+        EAL580B* findBySlaveId(int id);
+
+        /**
+         * @brief Update all encoders in PDO mode.
+         */
+        void updateValuesPDO(void);
+
+        /**
+         * @brief Update all encoders in PDO mode and validate samples.
+         * @param wkc is working counter returned by ec_receive_processdata() of this cycle.
+         */
+        void updateValuesPDO(int wkc);
+
+        /**
+         * @brief Capture input snapshots of all encoders. See EAL580B::captureInputs().
+         * @note Use in bus thread right after ec_receive_processdata().
+         * @return true if all encoders successed.
+         */
+        bool captureInputs(uint64_t cycle, int wkc = -1);
+
+        /**
+         * @brief Decode latest input snapshots of all encoders. See EAL580B::updateValuesSnapshot().
+         * @return Number of encoders with a new decoded snapshot.
+         */
+        size_t updateValuesSnapshot(void);
+
+        /**
+         * @brief Check process data size of all encoders. See EAL580B::verifyTxPDO().
+         * @note Use after ethercat configMap().
+         * @return true if all encoders successed.
+         */
+        bool verifyTxPDO(void);
+
+        /**
+         * @brief Read ethercat state and run one recovery step of all encoders. See EAL580B::recover().
+         * @note Steps of lost slaves block up to the SOEM state timeouts. Use periodically in a supervisor thread
+         * while process data cycle goes on.
+         * @return Number of encoders not in OP. (busy or failed recovery)
+         */
+        size_t recover(void);
+
+        /**
+         * @brief Register metrics of all encoders in registry. Use after scan().
+         */
+        void registerMetrics(EAL580B_MetricsRegistry &registry);
+
+    private:
+
+        std::vector<std::unique_ptr<EAL580B>> _encoders;
+
+        // Return true if slave matches vendor/product code and device name.
+        bool _isEncoder(uint16_t slave);
+};
+
+#endif
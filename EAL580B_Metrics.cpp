@@ -0,0 +1,249 @@
+#include "EAL580B_Metrics.h"
+#include <cstdio>                   // For snprintf and rename
+#include <cstring>                  // For memcmp
+#include <cstddef>                  // For offsetof
+#include <fcntl.h>                  // For open
+#include <unistd.h>                 // For write and close
+
+// #######################################################################
+
+// Export description of one metric field.
+struct _MetricInfoStruct
+{
+    const char* name;
+    const char* type;
+    const char* help;
+    size_t offset;
+    bool isSigned;
+};
+
+static const _MetricInfoStruct _metricInfo[] =
+{
+    {"eal580b_sdo_reads_total",         "counter",  "Number of SDO read calls.",                    offsetof(EAL580B_Metrics::SnapshotStruct, sdoReads),             false},
+    {"eal580b_sdo_writes_total",        "counter",  "Number of SDO write calls.",                   offsetof(EAL580B_Metrics::SnapshotStruct, sdoWrites),            false},
+    {"eal580b_sdo_failures_total",      "counter",  "Number of failed SDO calls.",                  offsetof(EAL580B_Metrics::SnapshotStruct, sdoFailures),          false},
+    {"eal580b_sdo_timeouts_total",      "counter",  "Number of SDO calls without response.",        offsetof(EAL580B_Metrics::SnapshotStruct, sdoTimeouts),          false},
+    {"eal580b_sdo_aborts_total",        "counter",  "Number of SDO calls aborted by slave.",        offsetof(EAL580B_Metrics::SnapshotStruct, sdoAborts),            false},
+    {"eal580b_sdo_rtt_ns_sum",          "counter",  "Sum of SDO round-trip times in ns.",           offsetof(EAL580B_Metrics::SnapshotStruct, sdoRttSumNs),          false},
+    {"eal580b_sdo_rtt_last_ns",         "gauge",    "Last SDO round-trip time in ns.",              offsetof(EAL580B_Metrics::SnapshotStruct, sdoRttLastNs),         false},
+    {"eal580b_sdo_rtt_max_ns",          "gauge",    "Maximum SDO round-trip time in ns.",           offsetof(EAL580B_Metrics::SnapshotStruct, sdoRttMaxNs),          false},
+    {"eal580b_pdo_decodes_total",       "counter",  "Number of decoded PDO samples.",               offsetof(EAL580B_Metrics::SnapshotStruct, pdoDecodes),           false},
+    {"eal580b_pdo_stale_total",         "counter",  "Number of not valid PDO samples.",             offsetof(EAL580B_Metrics::SnapshotStruct, pdoStale),             false},
+    {"eal580b_pdo_missed_total",        "counter",  "Number of PDO cycles with low working counter.", offsetof(EAL580B_Metrics::SnapshotStruct, pdoMissed),          false},
+    {"eal580b_temperature_celsius",     "gauge",    "Last read sensor temperature in degC.",        offsetof(EAL580B_Metrics::SnapshotStruct, temperature),          true},
+};
+
+// Read field of snapshot.
+static uint64_t fieldValue(const EAL580B_Metrics::SnapshotStruct &data, const _MetricInfoStruct &info)
+{
+    uint64_t value;
+    memcpy(&value, (const uint8_t*)&data + info.offset, sizeof(value));
+
+    return value;
+}
+
+// Append one series line.
+static void appendSeries(std::string &text, const _MetricInfoStruct &info, const char* slave, uint64_t value)
+{
+    char line[160];
+
+    if(info.isSigned)
+    {
+        snprintf(line, sizeof(line), "%s{slave=\"%s\"} %lld\n", info.name, slave, (long long)(int64_t)value);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "%s{slave=\"%s\"} %llu\n", info.name, slave, (unsigned long long)value);
+    }
+
+    text += line;
+}
+
+// #######################################################################
+// EAL580B_Metrics:
+
+bool EAL580B_Metrics::snapshot(SnapshotStruct &data) const
+{
+    uint64_t *first = (uint64_t*)&data;
+    uint64_t second[_FIELD_NUM];
+
+    for(int i = 0; i < _FIELD_NUM; i++)
+    {
+        first[i] = _fields[i].load(std::memory_order_relaxed);
+    }
+
+    for(int retry = 0; retry < 4; retry++)
+    {
+        for(int i = 0; i < _FIELD_NUM; i++)
+        {
+            second[i] = _fields[i].load(std::memory_order_relaxed);
+        }
+
+        if(memcmp(first, second, sizeof(second)) == 0)
+        {
+            return true;
+        }
+
+        memcpy(first, second, sizeof(second));
+    }
+
+    return false;
+}
+
+// #######################################################################
+// EAL580B_MetricsRegistry:
+
+void EAL580B_MetricsRegistry::add(int32_t slaveId, const EAL580B_Metrics* metrics)
+{
+    if(metrics == nullptr)
+    {
+        return;
+    }
+
+    _items.push_back({slaveId, metrics});
+}
+
+bool EAL580B_MetricsRegistry::snapshot(size_t index, EAL580B_Metrics::SnapshotStruct &data) const
+{
+    if(index >= _items.size())
+    {
+        return false;
+    }
+
+    return _items[index].metrics->snapshot(data);
+}
+
+void EAL580B_MetricsRegistry::aggregate(EAL580B_Metrics::SnapshotStruct &data) const
+{
+    data = {};
+
+    for(const _ItemStruct &item : _items)
+    {
+        EAL580B_Metrics::SnapshotStruct one;
+        item.metrics->snapshot(one);
+
+        data.sdoReads += one.sdoReads;
+        data.sdoWrites += one.sdoWrites;
+        data.sdoFailures += one.sdoFailures;
+        data.sdoTimeouts += one.sdoTimeouts;
+        data.sdoAborts += one.sdoAborts;
+        data.sdoRttSumNs += one.sdoRttSumNs;
+        data.pdoDecodes += one.pdoDecodes;
+        data.pdoStale += one.pdoStale;
+        data.pdoMissed += one.pdoMissed;
+
+        if(one.sdoRttMaxNs > data.sdoRttMaxNs)
+        {
+            data.sdoRttMaxNs = one.sdoRttMaxNs;
+        }
+
+        // Temperature of the encoder with the newest read.
+        if(one.temperatureTimeNs >= data.temperatureTimeNs)
+        {
+            data.temperature = one.temperature;
+            data.temperatureTimeNs = one.temperatureTimeNs;
+        }
+
+        // Last RTT of the last registered encoder with SDO calls.
+        if(one.sdoRttLastNs != 0)
+        {
+            data.sdoRttLastNs = one.sdoRttLastNs;
+        }
+    }
+}
+
+std::string EAL580B_MetricsRegistry::exportText(void) const
+{
+    std::vector<EAL580B_Metrics::SnapshotStruct> data(_items.size());
+
+    for(size_t i = 0; i < _items.size(); i++)
+    {
+        _items[i].metrics->snapshot(data[i]);
+    }
+
+    EAL580B_Metrics::SnapshotStruct all;
+    aggregate(all);
+
+    std::string text;
+    text.reserve(256 + 64 * (_items.size() + 1) * (sizeof(_metricInfo) / sizeof(_metricInfo[0])));
+
+    for(const _MetricInfoStruct &info : _metricInfo)
+    {
+        text += "# HELP ";
+        text += info.name;
+        text += " ";
+        text += info.help;
+        text += "\n# TYPE ";
+        text += info.name;
+        text += " ";
+        text += info.type;
+        text += "\n";
+
+        for(size_t i = 0; i < _items.size(); i++)
+        {
+            char slave[16];
+            snprintf(slave, sizeof(slave), "%d", (int)_items[i].slaveId);
+            appendSeries(text, info, slave, fieldValue(data[i], info));
+        }
+
+        appendSeries(text, info, "all", fieldValue(all, info));
+    }
+
+    return text;
+}
+
+// Write all bytes to file descriptor.
+static bool writeAll(int fd, const std::string &text)
+{
+    size_t done = 0;
+
+    while(done < text.size())
+    {
+        ssize_t num = write(fd, text.data() + done, text.size() - done);
+
+        if(num <= 0)
+        {
+            return false;
+        }
+
+        done += (size_t)num;
+    }
+
+    return true;
+}
+
+bool EAL580B_MetricsRegistry::exportFile(const char* path)
+{
+    std::string tempPath = std::string(path) + ".tmp";
+
+    int fd = open(tempPath.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+
+    if(fd < 0)
+    {
+        errorMessage = "Error Metrics Registry: exportFile() can not create file.";
+        return false;
+    }
+
+    bool state = writeAll(fd, exportText());
+    close(fd);
+
+    if( !state || (rename(tempPath.c_str(), path) != 0) )
+    {
+        errorMessage = "Error Metrics Registry: exportFile() can not write file.";
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool EAL580B_MetricsRegistry::exportFd(int fd)
+{
+    if(!writeAll(fd, exportText()))
+    {
+        errorMessage = "Error Metrics Registry: exportFd() can not write.";
+        return false;
+    }
+
+    return true;
+}
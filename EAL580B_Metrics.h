@@ -0,0 +1,215 @@
+#ifndef _EAL580B_METRICS_H
+#define _EAL580B_METRICS_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For lock-free counters
+#include <string>                   // For text export
+#include <vector>                   // For registry list
+
+// #################################################################################
+/**
+ * @brief Atomic counters and gauges of one encoder.
+ * Each update is one relaxed atomic operation. Any thread can take a snapshot.
+ * @note No heap memory. Safe to update from the real-time thread.
+ */
+class EAL580B_Metrics
+{
+    public:
+
+        /// Plain copy of all metrics. All fields are 64 bit, so there is no padding.
+        struct SnapshotStruct
+        {
+            /// Number of SDO read calls.
+            uint64_t sdoReads;
+
+            /// Number of SDO write calls.
+            uint64_t sdoWrites;
+
+            /// Number of failed SDO calls. (timeouts + aborts)
+            uint64_t sdoFailures;
+
+            /// Number of SDO calls without response.
+            uint64_t sdoTimeouts;
+
+            /// Number of SDO calls aborted by slave.
+            uint64_t sdoAborts;
+
+            /// Sum of SDO round-trip times. [ns]
+            uint64_t sdoRttSumNs;
+
+            /// Last SDO round-trip time. [ns]
+            uint64_t sdoRttLastNs;
+
+            /// Maximum SDO round-trip time. [ns]
+            uint64_t sdoRttMaxNs;
+
+            /// Number of decoded PDO samples.
+            uint64_t pdoDecodes;
+
+            /// Number of PDO samples that were not valid. (value.status != SAMPLE_VALID)
+            uint64_t pdoStale;
+
+            /// Number of PDO cycles with low working counter.
+            uint64_t pdoMissed;
+
+            /// Last read sensor temperature. [degC]
+            int64_t temperature;
+
+            /// Steady clock time of last temperature read. [ns] 0 means never read.
+            uint64_t temperatureTimeNs;
+        };
+
+        EAL580B_Metrics() {reset();}
+
+        /// @brief Set all metrics to zero. Do not use while other threads update.
+        void reset(void)
+        {
+            for(int i = 0; i < _FIELD_NUM; i++)
+            {
+                _fields[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Count one SDO call.
+         * @param write: true for SDO write.
+         * @param wkc is working counter of call.
+         * @param aborted: true if slave aborted transfer.
+         * @param rttNs is round-trip time of call. [ns]
+         */
+        void addSdo(bool write, int wkc, bool aborted, uint64_t rttNs)
+        {
+            _add(write ? _SDO_WRITES : _SDO_READS, 1);
+
+            if(wkc <= 0)
+            {
+                _add(_SDO_FAILURES, 1);
+                _add(aborted ? _SDO_ABORTS : _SDO_TIMEOUTS, 1);
+            }
+
+            _add(_SDO_RTT_SUM_NS, rttNs);
+            _fields[_SDO_RTT_LAST_NS].store(rttNs, std::memory_order_relaxed);
+
+            uint64_t max = _fields[_SDO_RTT_MAX_NS].load(std::memory_order_relaxed);
+
+            while( (rttNs > max) && !_fields[_SDO_RTT_MAX_NS].compare_exchange_weak(max, rttNs, std::memory_order_relaxed) )
+            {
+            }
+        }
+
+        /// @brief Count one decoded PDO sample.
+        void addPdoDecode(void) {_add(_PDO_DECODES, 1);}
+
+        /// @brief Count one not valid PDO sample.
+        void addPdoStale(void) {_add(_PDO_STALE, 1);}
+
+        /// @brief Count one PDO cycle with low working counter.
+        void addPdoMissed(void) {_add(_PDO_MISSED, 1);}
+
+        /// @brief Set temperature gauge. [degC]
+        void setTemperature(int32_t value, uint64_t timeNs)
+        {
+            _fields[_TEMPERATURE].store((uint64_t)(int64_t)value, std::memory_order_relaxed);
+            _fields[_TEMPERATURE_TIME_NS].store(timeNs, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Take a copy of all metrics.
+         * All fields are read twice until both reads are equal, so the copy is consistent
+         * when no update happens between the two reads.
+         * @return false if metrics were changing for all retries. Copy is still usable.
+         */
+        bool snapshot(SnapshotStruct &data) const;
+
+    private:
+
+        enum : int
+        {
+            _SDO_READS = 0,
+            _SDO_WRITES,
+            _SDO_FAILURES,
+            _SDO_TIMEOUTS,
+            _SDO_ABORTS,
+            _SDO_RTT_SUM_NS,
+            _SDO_RTT_LAST_NS,
+            _SDO_RTT_MAX_NS,
+            _PDO_DECODES,
+            _PDO_STALE,
+            _PDO_MISSED,
+            _TEMPERATURE,
+            _TEMPERATURE_TIME_NS,
+            _FIELD_NUM
+        };
+
+        static_assert(sizeof(SnapshotStruct) == _FIELD_NUM * sizeof(uint64_t), "SnapshotStruct fields must match metric fields.");
+
+        std::atomic<uint64_t> _fields[_FIELD_NUM];
+
+        void _add(int field, uint64_t value) {_fields[field].fetch_add(value, std::memory_order_relaxed);}
+};
+
+// #################################################################################
+/**
+ * @brief Registry of encoder metrics. Gives per-encoder and aggregate snapshots
+ * and exports them in Prometheus text exposition format.
+ * @note Registry only keeps pointers. Registered metrics must stay alive. Do not add at cycle time.
+ */
+class EAL580B_MetricsRegistry
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        /**
+         * @brief Register metrics of an encoder.
+         * @param slaveId is used as slave label in export.
+         */
+        void add(int32_t slaveId, const EAL580B_Metrics* metrics);
+
+        /// @brief Remove all registered metrics.
+        void clear(void) {_items.clear();}
+
+        /// @brief Return number of registered metrics.
+        size_t size(void) const {return _items.size();}
+
+        /// @brief Take snapshot of registered metrics by index.
+        bool snapshot(size_t index, EAL580B_Metrics::SnapshotStruct &data) const;
+
+        /**
+         * @brief Take aggregate snapshot of all registered metrics.
+         * Counters are summed. RTT max is the maximum. Temperature is the newest read one.
+         */
+        void aggregate(EAL580B_Metrics::SnapshotStruct &data) const;
+
+        /**
+         * @brief Return all metrics in Prometheus text exposition format.
+         * Per-encoder series have label slave="<id>". Aggregate series have label slave="all".
+         */
+        std::string exportText(void) const;
+
+        /**
+         * @brief Write exportText() to a file. File is replaced atomically. (write temporary file and rename)
+         * @return true if successed.
+         */
+        bool exportFile(const char* path);
+
+        /**
+         * @brief Write exportText() to an open file descriptor. e.g. an accepted unix or TCP socket.
+         * @return true if successed.
+         */
+        bool exportFd(int fd);
+
+    private:
+
+        struct _ItemStruct
+        {
+            int32_t slaveId;
+            const EAL580B_Metrics *metrics;
+        };
+
+        std::vector<_ItemStruct> _items;
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include "EAL580B_PositionCompare.h"
+#include <algorithm>                // For sort and binary search
+#include <numeric>                  // For iota
+#include <limits>                   // For infinity
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_PositionCompare::EAL580B_PositionCompare()
+{
+    parameters.RANGE_DEG = 0;
+
+    _eventCount = 0;
+    _overflowCount = 0;
+    _prevPos = 0;
+    _prevValid = false;
+}
+
+bool EAL580B_PositionCompare::addWindow(uint32_t id, double startDeg, double endDeg)
+{
+    if(startDeg >= endDeg)
+    {
+        return false;
+    }
+
+    _pendingEdge.push_back({id, _EDGE_START});
+    _pendingPos.push_back(startDeg);
+    _pendingEdge.push_back({id, _EDGE_END});
+    _pendingPos.push_back(endDeg);
+
+    return true;
+}
+
+void EAL580B_PositionCompare::addTrigger(uint32_t id, double posDeg)
+{
+    _pendingEdge.push_back({id, _EDGE_TRIGGER});
+    _pendingPos.push_back(posDeg);
+}
+
+void EAL580B_PositionCompare::clear(void)
+{
+    _pendingEdge.clear();
+    _pendingPos.clear();
+}
+
+void EAL580B_PositionCompare::build(uint16_t eventCapacity)
+{
+    std::vector<uint32_t> order(_pendingPos.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // Stable sort keeps add order for edges at same position.
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+    {
+        return _pendingPos[a] < _pendingPos[b];
+    });
+
+    _edgePos.resize(order.size());
+    _edge.resize(order.size());
+
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        _edgePos[i] = _pendingPos[order[i]];
+        _edge[i] = _pendingEdge[order[i]];
+    }
+
+    _events.resize(eventCapacity);
+    _eventCount = 0;
+}
+
+void EAL580B_PositionCompare::reset(void)
+{
+    _prevValid = false;
+    _eventCount = 0;
+}
+
+bool EAL580B_PositionCompare::_pushEvent(uint32_t i, int8_t direction)
+{
+    if(_eventCount >= _events.size())
+    {
+        _overflowCount++;
+        return false;
+    }
+
+    EventStruct &event = _events[_eventCount++];
+
+    event.id = _edge[i].id;
+    event.direction = direction;
+    event.position = _edgePos[i];
+
+    switch(_edge[i].kind)
+    {
+        case _EDGE_START:
+            event.type = (direction > 0) ? PCMP_EVENT_ENTER : PCMP_EVENT_LEAVE;
+        break;
+        case _EDGE_END:
+            event.type = (direction > 0) ? PCMP_EVENT_LEAVE : PCMP_EVENT_ENTER;
+        break;
+        default:
+            event.type = PCMP_EVENT_TRIGGER;
+    }
+
+    return true;
+}
+
+uint16_t EAL580B_PositionCompare::update(double posDeg)
+{
+    _eventCount = 0;
+
+    if(_prevValid == false)
+    {
+        _prevPos = posDeg;
+        _prevValid = true;
+        return 0;
+    }
+
+    if(posDeg == _prevPos)
+    {
+        return 0;
+    }
+
+    double delta = posDeg - _prevPos;
+    double prevPos = _prevPos;
+    double range = parameters.RANGE_DEG;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    _prevPos = posDeg;
+
+    if( (range > 0) && (delta > 0.5 * range) )
+    {
+        // Backward over the wrap: down to 0, then down from range.
+        _sweep(-inf, prevPos, -1);
+        _sweep(posDeg, inf, -1);
+    }
+    else if( (range > 0) && (delta < -0.5 * range) )
+    {
+        // Forward over the wrap: up to range, then up from 0.
+        _sweep(prevPos, inf, 1);
+        _sweep(-inf, posDeg, 1);
+    }
+    else if(delta > 0)
+    {
+        _sweep(prevPos, posDeg, 1);
+    }
+    else
+    {
+        _sweep(posDeg, prevPos, -1);
+    }
+
+    return _eventCount;
+}
+
+void EAL580B_PositionCompare::_sweep(double lo, double hi, int8_t direction)
+{
+    // Edge e is crossed if it lies in (lo, hi]. This keeps half open windows [start, end) consistent in both directions.
+    const double *edgeBegin = _edgePos.data();
+    const double *edgeEnd = edgeBegin + _edgePos.size();
+    const double *first = std::upper_bound(edgeBegin, edgeEnd, lo);
+    const double *last = std::upper_bound(first, edgeEnd, hi);
+
+    uint32_t begin = (uint32_t)(first - edgeBegin);
+    uint32_t end = (uint32_t)(last - edgeBegin);
+
+    if(direction > 0)
+    {
+        for(uint32_t i = begin; i < end; i++)
+        {
+            if(!_pushEvent(i, 1))
+            {
+                _overflowCount += (end - i - 1);
+                break;
+            }
+        }
+    }
+    else
+    {
+        for(uint32_t i = end; i > begin; i--)
+        {
+            if(!_pushEvent(i - 1, -1))
+            {
+                _overflowCount += (i - 1 - begin);
+                break;
+            }
+        }
+    }
+}
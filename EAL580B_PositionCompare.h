@@ -0,0 +1,143 @@
+#ifndef _EAL580B_POSITIONCOMPARE_H
+#define _EAL580B_POSITIONCOMPARE_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <vector>                   // For edge and event storage
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Position compare event types:
+    #define PCMP_EVENT_ENTER                0x01
+    #define PCMP_EVENT_LEAVE                0x02
+    #define PCMP_EVENT_TRIGGER              0x03
+}
+
+// #################################################################################
+/**
+ * @brief Position compare / electronic cam engine.
+ * Holds a sorted index of cam windows and trigger points and reports, for each new position sample,
+ * every window edge or trigger point crossed since the previous sample.
+ * @note Cost of update() is O(log n + events). Edges skipped between two samples are reported too.
+ * @note Windows are half open: position p is inside window if start <= p < end.
+ */
+class EAL580B_PositionCompare
+{
+    public:
+
+        struct ParameterStruct
+        {
+            /**
+             * @brief Position range where position wraps to 0. [deg] A step of more than half range is a crossing of the wrap.
+             * @note Value 0 means position does not wrap. The default value is 0. Edges must be in [0, RANGE_DEG).
+             */
+            double RANGE_DEG;
+
+        }parameters;
+
+        struct EventStruct
+        {
+            /// User id of window or trigger point.
+            uint32_t id;
+
+            /// Event type. PCMP_EVENT_ENTER, PCMP_EVENT_LEAVE or PCMP_EVENT_TRIGGER.
+            uint8_t type;
+
+            /// Moving direction while crossing. 1: position increasing, -1: position decreasing.
+            int8_t direction;
+
+            /// Position of the crossed edge. [deg]
+            double position;
+        };
+
+        /// @brief Default constructor.
+        EAL580B_PositionCompare();
+
+        /**
+         * @brief Add cam window. Take effect after build().
+         * @param id is user id for window. It is reported in events.
+         * @param startDeg is start position of window. [deg]
+         * @param endDeg is end position of window. [deg]
+         * @return true if successed. false if startDeg >= endDeg.
+         */
+        bool addWindow(uint32_t id, double startDeg, double endDeg);
+
+        /**
+         * @brief Add trigger point. Take effect after build().
+         * @param id is user id for trigger point. It is reported in events.
+         * @param posDeg is trigger position. [deg]
+         */
+        void addTrigger(uint32_t id, double posDeg);
+
+        /// @brief Remove all windows and trigger points. Take effect after build().
+        void clear(void);
+
+        /**
+         * @brief Sort edges and rebuild index. Allocates memory.
+         * @param eventCapacity is maximum number of events reported per update().
+         * @note Do not call this function concurrent with update().
+         */
+        void build(uint16_t eventCapacity = 256);
+
+        /**
+         * @brief Forget previous sample. Next update() only latches position and reports no events.
+         */
+        void reset(void);
+
+        /**
+         * @brief Evaluate crossed edges between previous sample and new position. No memory allocation.
+         * @param posDeg is new position sample. [deg]
+         * @return Number of events. Events are ordered by moving direction.
+         */
+        uint16_t update(double posDeg);
+
+        /// @brief Return events of last update().
+        const EventStruct* getEvents(void) const {return _events.data();}
+
+        /// @brief Return number of events of last update().
+        uint16_t getEventCount(void) const {return _eventCount;}
+
+        /// @brief Return total number of events dropped because event capacity was full.
+        uint32_t getOverflowCount(void) const {return _overflowCount;}
+
+        /// @brief Return number of indexed edges. (windows count 2 edges)
+        uint32_t getEdgeCount(void) const {return (uint32_t)_edgePos.size();}
+
+    private:
+
+        struct _EdgeStruct
+        {
+            uint32_t id;
+            uint8_t kind;
+        };
+
+        // Edge kinds:
+        static const uint8_t _EDGE_START = 0;
+        static const uint8_t _EDGE_END = 1;
+        static const uint8_t _EDGE_TRIGGER = 2;
+
+        // Windows and triggers added by user. Rebuilt into sorted edges in build().
+        std::vector<_EdgeStruct> _pendingEdge;
+        std::vector<double> _pendingPos;
+
+        // Sorted edge positions and parallel edge info. Positions kept contiguous for binary search.
+        std::vector<double> _edgePos;
+        std::vector<_EdgeStruct> _edge;
+
+        std::vector<EventStruct> _events;
+        uint16_t _eventCount;
+        uint32_t _overflowCount;
+
+        double _prevPos;
+        bool _prevValid;
+
+        // Append event for edge index i. Return false if event capacity is full.
+        bool _pushEvent(uint32_t i, int8_t direction);
+
+        // Report edges in (lo, hi] in moving direction.
+        void _sweep(double lo, double hi, int8_t direction);
+};
+
+#endif
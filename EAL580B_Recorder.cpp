@@ -0,0 +1,142 @@
+#include "EAL580B_Recorder.h"
+#include <cstring>                  // For memcpy
+#include <fcntl.h>                  // For open
+#include <sys/mman.h>               // For mmap
+#include <unistd.h>                 // For close
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_Recorder::EAL580B_Recorder()
+{
+    _segmentBytes = 0;
+    _capacity = 0;
+    _active = 0;
+    _header = nullptr;
+    _records = nullptr;
+    _sequence = 0;
+    _recordTotal = 0;
+}
+
+EAL580B_Recorder::~EAL580B_Recorder()
+{
+    close();
+}
+
+bool EAL580B_Recorder::open(const char* prefix, uint64_t segmentBytes, uint16_t segmentNum)
+{
+    close();
+
+    if( (segmentNum == 0) || (segmentBytes < sizeof(SegmentHeaderStruct) + sizeof(RecordStruct)) )
+    {
+        errorMessage = "Error Recorder: open() segment size or number is not correct.";
+        return false;
+    }
+
+    _segmentBytes = segmentBytes;
+    _capacity = (uint32_t)((segmentBytes - sizeof(SegmentHeaderStruct)) / sizeof(RecordStruct));
+
+    for(uint16_t i = 0; i < segmentNum; i++)
+    {
+        std::string name = std::string(prefix) + "_" + std::to_string(i) + ".bin";
+
+        int fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if(fd < 0)
+        {
+            errorMessage = "Error Recorder: open() can not create segment file.";
+            close();
+            return false;
+        }
+
+        // Allocate disk blocks now. So writing to mapped region can not fail later for lack of disk space.
+        if(posix_fallocate(fd, 0, (off_t)segmentBytes) != 0)
+        {
+            errorMessage = "Error Recorder: open() can not allocate segment file.";
+            ::close(fd);
+            close();
+            return false;
+        }
+
+        void *map = mmap(nullptr, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+
+        if(map == MAP_FAILED)
+        {
+            errorMessage = "Error Recorder: open() can not map segment file.";
+            ::close(fd);
+            close();
+            return false;
+        }
+
+        // Empty segment. Sequence 0 means never used.
+        memset(map, 0, sizeof(SegmentHeaderStruct));
+
+        _segments.push_back({fd, (uint8_t*)map});
+    }
+
+    _sequence = 0;
+    _recordTotal = 0;
+    _startSegment(0);
+
+    return true;
+}
+
+void EAL580B_Recorder::close(void)
+{
+    for(size_t i = 0; i < _segments.size(); i++)
+    {
+        msync(_segments[i].map, _segmentBytes, MS_SYNC);
+        munmap(_segments[i].map, _segmentBytes);
+        ::close(_segments[i].fd);
+    }
+
+    _segments.clear();
+    _header = nullptr;
+    _records = nullptr;
+}
+
+void EAL580B_Recorder::flush(void)
+{
+    for(size_t i = 0; i < _segments.size(); i++)
+    {
+        msync(_segments[i].map, _segmentBytes, MS_ASYNC);
+    }
+}
+
+void EAL580B_Recorder::_startSegment(uint16_t index)
+{
+    _active = index;
+    _header = (SegmentHeaderStruct*)_segments[index].map;
+    _records = (RecordStruct*)(_segments[index].map + sizeof(SegmentHeaderStruct));
+
+    _header->magic = RECORDER_MAGIC;
+    _header->version = RECORDER_VERSION;
+    _header->recordSize = sizeof(RecordStruct);
+    _header->capacity = _capacity;
+    _header->recordCount = 0;
+    _header->sequence = ++_sequence;
+}
+
+bool EAL580B_Recorder::record(const RecordStruct &data)
+{
+    if(_header == nullptr)
+    {
+        return false;
+    }
+
+    if(_header->recordCount >= _capacity)
+    {
+        _startSegment((uint16_t)((_active + 1) % _segments.size()));
+    }
+
+    memcpy(&_records[_header->recordCount], &data, sizeof(RecordStruct));
+
+    // Count is updated after the record. So a crashed process leaves only complete records.
+    _header->recordCount++;
+    _recordTotal++;
+
+    return true;
+}
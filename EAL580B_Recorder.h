@@ -0,0 +1,146 @@
+#ifndef _EAL580B_RECORDER_H
+#define _EAL580B_RECORDER_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <string>                   // For file names
+#include <vector>                   // For segment list
+#include "EAL580B_Clock.h"          // Shared host time base
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Recorder segment file identification:
+    #define RECORDER_MAGIC                  0x42303835      // 0:'5', 1:'8', 2:'0', 3:'B'
+    #define RECORDER_VERSION                2
+}
+
+// #################################################################################
+/**
+ * @brief Binary sample recorder on preallocated memory-mapped segment files.
+ * Segment files are created, allocated and mapped in open(). At cycle time record() only copies one fixed-size
+ * record into the mapped region. When a segment is full recording continues on the next segment and the oldest
+ * segment is overwritten. (size-based rotation)
+ * @note Segment files are named <prefix>_<n>.bin. Use examples/recorder2csv to convert them to CSV.
+ * @note record() is not thread safe. Call it from one thread. (usually the cyclic thread)
+ */
+class EAL580B_Recorder
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        /// Fixed-size binary record. 56 bytes.
+        struct RecordStruct
+        {
+            /// Host time of sample. [ns] Steady clock time base of EAL580B::nowNs(). (ValueStruct::timeNs)
+            uint64_t timeNs;
+
+            uint32_t posStep;
+            uint32_t posRawStep;
+            int32_t velStep;
+
+            /// Low byte: slave state (ec_slave[].state) at sample time. High byte: sample status flags. (ValueStruct::status)
+            uint16_t status;
+
+            /// Ethercat slave id of the encoder.
+            uint16_t slaveId;
+
+            /// Number of valid bytes in inputs.
+            uint8_t inputSize;
+
+            uint8_t reserved[3];
+
+            /// Raw process data input image of the slave. Used by EAL580B_Replay to feed the decode path.
+            uint8_t inputs[28];
+        };
+
+        /// Segment file header. 64 bytes. Records follow the header.
+        struct SegmentHeaderStruct
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t recordSize;
+
+            /// Capacity of segment in records.
+            uint32_t capacity;
+
+            /// Rotation sequence number. Increase each time a segment is (re)started. Order of segments when reading.
+            uint32_t sequence;
+
+            /// Number of valid records in segment.
+            uint64_t recordCount;
+
+            uint8_t reserved[40];
+        };
+
+        /// @brief Default constructor.
+        EAL580B_Recorder();
+
+        /// @brief Destructor. Close recorder.
+        ~EAL580B_Recorder();
+
+        /**
+         * @brief Create, allocate and map segment files. Do not use at cycle time.
+         * @param prefix is path prefix of segment files.
+         * @param segmentBytes is size of each segment file in bytes.
+         * @param segmentNum is number of segment files for rotation. Minimum 1.
+         * @return true if successed.
+         */
+        bool open(const char* prefix, uint64_t segmentBytes, uint16_t segmentNum);
+
+        /**
+         * @brief Flush mapped segments to disk and unmap them. Do not use at cycle time.
+         */
+        void close(void);
+
+        /**
+         * @brief Append one record. Only a memcpy into the mapped region. No system call.
+         * @return false if recorder is not open.
+         */
+        bool record(const RecordStruct &data);
+
+        /**
+         * @brief Request asynchronous write back of mapped segments to disk. Do not use at cycle time.
+         */
+        void flush(void);
+
+        /// @brief Return true if recorder is open.
+        bool isOpen(void) const {return _segments.size() > 0;}
+
+        /// @brief Return total number of records written since open().
+        uint64_t getRecordCount(void) const {return _recordTotal;}
+
+        /// @brief Return host time now. [ns] The time base of RecordStruct::timeNs.
+        static uint64_t nowNs(void) {return EAL580B_nowNs();}
+
+    private:
+
+        struct _SegmentStruct
+        {
+            int fd;
+            uint8_t *map;
+        };
+
+        std::vector<_SegmentStruct> _segments;
+
+        uint64_t _segmentBytes;
+
+        // Capacity of each segment in records.
+        uint32_t _capacity;
+
+        // Active segment index and its header/records.
+        uint16_t _active;
+        SegmentHeaderStruct *_header;
+        RecordStruct *_records;
+
+        uint32_t _sequence;
+        uint64_t _recordTotal;
+
+        // Start recording on segment index. Just pointer and header updates.
+        void _startSegment(uint16_t index);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "EAL580B_Replay.h"
+#include <algorithm>                // For sort
+#include <cstring>                  // For memcpy
+#include <fstream>                  // For file read
+#include <thread>                   // For sleep
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_Replay::EAL580B_Replay()
+{
+    _index = 0;
+    _inputSize = 0;
+    _originalTiming = false;
+    memset(_inputs, 0, sizeof(_inputs));
+}
+
+bool EAL580B_Replay::open(const std::vector<std::string> &files, uint16_t slaveId)
+{
+    std::vector<std::pair<uint32_t, std::vector<EAL580B_Recorder::RecordStruct>>> segments;
+
+    for(const std::string &name : files)
+    {
+        std::ifstream file(name, std::ios::binary);
+        EAL580B_Recorder::SegmentHeaderStruct header;
+
+        if(!file.read((char*)&header, sizeof(header)))
+        {
+            errorMessage = "Error Replay: open() can not read segment header.";
+            return false;
+        }
+
+        if( (header.magic != RECORDER_MAGIC) || (header.version != RECORDER_VERSION) || (header.recordSize != sizeof(EAL580B_Recorder::RecordStruct)) )
+        {
+            errorMessage = "Error Replay: open() segment format is not supported.";
+            return false;
+        }
+
+        // Sequence 0 means segment was never used.
+        if(header.sequence == 0)
+        {
+            continue;
+        }
+
+        uint64_t count = std::min<uint64_t>(header.recordCount, header.capacity);
+        std::vector<EAL580B_Recorder::RecordStruct> records(count);
+
+        file.read((char*)records.data(), count * sizeof(EAL580B_Recorder::RecordStruct));
+        records.resize(file.gcount() / sizeof(EAL580B_Recorder::RecordStruct));
+
+        segments.push_back({header.sequence, std::move(records)});
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const auto &a, const auto &b)
+    {
+        return a.first < b.first;
+    });
+
+    _records.clear();
+
+    for(const auto &segment : segments)
+    {
+        for(const EAL580B_Recorder::RecordStruct &record : segment.second)
+        {
+            if( (record.slaveId == slaveId) && (record.inputSize > 0) )
+            {
+                _records.push_back(record);
+            }
+        }
+    }
+
+    rewind();
+
+    if(_records.size() == 0)
+    {
+        errorMessage = "Error Replay: open() no record with input image found for slave.";
+        return false;
+    }
+
+    return true;
+}
+
+void EAL580B_Replay::rewind(void)
+{
+    _index = 0;
+}
+
+bool EAL580B_Replay::next(void)
+{
+    if(_index >= _records.size())
+    {
+        return false;
+    }
+
+    const EAL580B_Recorder::RecordStruct &record = _records[_index];
+
+    if(_originalTiming)
+    {
+        if(_index == 0)
+        {
+            _startTime = std::chrono::steady_clock::now();
+        }
+        else
+        {
+            std::this_thread::sleep_until(_startTime + std::chrono::nanoseconds(record.timeNs - _records[0].timeNs));
+        }
+    }
+
+    _inputSize = std::min<uint8_t>(record.inputSize, sizeof(_inputs));
+    memcpy(_inputs, record.inputs, _inputSize);
+
+    _index++;
+
+    return true;
+}
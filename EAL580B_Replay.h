@@ -0,0 +1,80 @@
+#ifndef _EAL580B_REPLAY_H
+#define _EAL580B_REPLAY_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <string>                   // For file names
+#include <vector>                   // For record storage
+#include <chrono>                   // For time managements
+#include "EAL580B_Recorder.h"       // Record and segment formats
+
+// #################################################################################
+/**
+ * @brief Replay of recorded process data for one encoder.
+ * Loads EAL580B_Recorder segment files and provides the recorded raw input image of one slave, record by record.
+ * An EAL580B object initialized by EAL580B::initReplay() decodes these bytes instead of ec_slave[].inputs.
+ * So the updateValuesPDO() -> conversion -> consumer pipeline can run offline on real data.
+ * @note Usage: while(replay.next()) { encoder.updateValuesPDO(); ... }
+ */
+class EAL580B_Replay
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        /// @brief Default constructor.
+        EAL580B_Replay();
+
+        /**
+         * @brief Load records of one slave from segment files. Segments are ordered by rotation sequence.
+         * @param files is list of segment files.
+         * @param slaveId is the recorded ethercat slave id to replay.
+         * @return true if successed and at least one record with input image found.
+         */
+        bool open(const std::vector<std::string> &files, uint16_t slaveId);
+
+        /**
+         * @brief Set replay timing.
+         * @param originalTiming: false -> replay as fast as possible. true -> next() waits to keep recorded time intervals.
+         */
+        void setTiming(bool originalTiming) {_originalTiming = originalTiming;}
+
+        /**
+         * @brief Load next record into input buffer.
+         * @return false if end of capture reached.
+         */
+        bool next(void);
+
+        /// @brief Restart replay from first record.
+        void rewind(void);
+
+        /// @brief Return input buffer. Its address is fixed for life of object.
+        uint8_t* getInputs(void) {return _inputs;}
+
+        /// @brief Return number of valid bytes of current input buffer.
+        uint8_t getInputSize(void) const {return _inputSize;}
+
+        /// @brief Return current record. Valid after a successful next().
+        const EAL580B_Recorder::RecordStruct& getRecord(void) const {return _records[_index - 1];}
+
+        /// @brief Return number of loaded records.
+        uint64_t getRecordCount(void) const {return _records.size();}
+
+    private:
+
+        std::vector<EAL580B_Recorder::RecordStruct> _records;
+
+        // Index of next record.
+        uint64_t _index;
+
+        uint8_t _inputs[sizeof(EAL580B_Recorder::RecordStruct::inputs)];
+        uint8_t _inputSize;
+
+        bool _originalTiming;
+
+        // Host time at first next() after open/rewind. Used for original timing.
+        std::chrono::steady_clock::time_point _startTime;
+};
+
+#endif
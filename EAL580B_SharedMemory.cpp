@@ -0,0 +1,325 @@
+#include "EAL580B_SharedMemory.h"
+#include <fcntl.h>                  // For O_* constants
+#include <sys/mman.h>               // For shm_open and mmap
+#include <unistd.h>                 // For ftruncate and close
+#include <new>                      // For placement new
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+using namespace EAL580B_ShmLayout;
+
+// #######################################################################
+
+// Copy sample out of a seqlock entry. Return false if entry was changed while copying or does not hold expected sequence.
+static bool readEntry(const EntryStruct &entry, uint64_t expectedSeq, EAL580B_ShmSampleStruct &sample, uint64_t &seq)
+{
+    seq = entry.seq.load(std::memory_order_acquire);
+
+    if( (seq & 1) || ((expectedSeq != 0) && (seq != expectedSeq)) )
+    {
+        return false;
+    }
+
+    sample = entry.sample;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return entry.seq.load(std::memory_order_relaxed) == seq;
+}
+
+// Write sample into a seqlock entry with final sequence seq.
+static void writeEntry(EntryStruct &entry, uint64_t seq, const EAL580B_ShmSampleStruct &sample)
+{
+    entry.seq.store(seq - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.sample = sample;
+    entry.seq.store(seq, std::memory_order_release);
+}
+
+// #######################################################################
+// EAL580B_ShmPublisher:
+
+EAL580B_ShmPublisher::EAL580B_ShmPublisher()
+{
+    _map = nullptr;
+    _bytes = 0;
+    _header = nullptr;
+}
+
+EAL580B_ShmPublisher::~EAL580B_ShmPublisher()
+{
+    close();
+}
+
+bool EAL580B_ShmPublisher::open(const char* name, uint16_t slotNum, uint32_t ringSize)
+{
+    close();
+
+    if( (slotNum == 0) || (ringSize == 0) || ((ringSize & (ringSize - 1)) != 0) )
+    {
+        errorMessage = "Error Shm Publisher: open() slot number or ring size is not correct.";
+        return false;
+    }
+
+    _bytes = segmentBytes(slotNum, ringSize);
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+
+    if(fd < 0)
+    {
+        errorMessage = "Error Shm Publisher: open() can not create shared memory.";
+        return false;
+    }
+
+    if(ftruncate(fd, (off_t)_bytes) != 0)
+    {
+        errorMessage = "Error Shm Publisher: open() can not resize shared memory.";
+        ::close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    ::close(fd);
+
+    if(map == MAP_FAILED)
+    {
+        errorMessage = "Error Shm Publisher: open() can not map shared memory.";
+        return false;
+    }
+
+    _name = name;
+    _map = (uint8_t*)map;
+    _header = (HeaderStruct*)_map;
+
+    // Magic is written last. Readers reject segment until it is initialized.
+    _header->magic = 0;
+    _header->version = SHM_VERSION;
+    _header->slotNum = slotNum;
+    _header->ringSize = ringSize;
+    _header->sampleSize = sizeof(EAL580B_ShmSampleStruct);
+    _header->slotBytes = slotBytes(ringSize);
+
+    for(uint16_t i = 0; i < slotNum; i++)
+    {
+        uint8_t *slot = _map + sizeof(HeaderStruct) + i * _header->slotBytes;
+
+        SlotHeaderStruct *slotHeader = new(slot) SlotHeaderStruct;
+        slotHeader->head.store(0, std::memory_order_relaxed);
+        slotHeader->latest.seq.store(0, std::memory_order_relaxed);
+
+        EntryStruct *ring = (EntryStruct*)(slot + sizeof(SlotHeaderStruct));
+
+        for(uint32_t j = 0; j < ringSize; j++)
+        {
+            EntryStruct *entry = new(&ring[j]) EntryStruct;
+            entry->seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = SHM_MAGIC;
+
+    return true;
+}
+
+void EAL580B_ShmPublisher::close(bool unlink)
+{
+    if(_map == nullptr)
+    {
+        return;
+    }
+
+    munmap(_map, _bytes);
+
+    if(unlink)
+    {
+        shm_unlink(_name.c_str());
+    }
+
+    _map = nullptr;
+    _header = nullptr;
+}
+
+bool EAL580B_ShmPublisher::publish(uint16_t slot, int32_t slaveId, const EAL580B::ValueStruct &value)
+{
+    if( (_header == nullptr) || (slot >= _header->slotNum) )
+    {
+        return false;
+    }
+
+    uint8_t *slotMap = _map + sizeof(HeaderStruct) + slot * _header->slotBytes;
+    SlotHeaderStruct *slotHeader = (SlotHeaderStruct*)slotMap;
+    EntryStruct *ring = (EntryStruct*)(slotMap + sizeof(SlotHeaderStruct));
+
+    EAL580B_ShmSampleStruct sample;
+    sample.timeNs = value.timeNs;
+    sample.slaveId = slaveId;
+    sample.value = value;
+
+    // Single writer per slot. So head is just loaded and stored.
+    uint64_t pos = slotHeader->head.load(std::memory_order_relaxed);
+
+    // Even sequence 2 * (pos + 1) marks complete sample number pos. 0 means never written.
+    writeEntry(ring[pos & (_header->ringSize - 1)], 2 * (pos + 1), sample);
+    writeEntry(slotHeader->latest, 2 * (pos + 1), sample);
+
+    slotHeader->head.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+// #######################################################################
+// EAL580B_ShmReader:
+
+EAL580B_ShmReader::EAL580B_ShmReader()
+{
+    _map = nullptr;
+    _bytes = 0;
+    _header = nullptr;
+}
+
+EAL580B_ShmReader::~EAL580B_ShmReader()
+{
+    close();
+}
+
+bool EAL580B_ShmReader::open(const char* name)
+{
+    close();
+
+    int fd = shm_open(name, O_RDONLY, 0);
+
+    if(fd < 0)
+    {
+        errorMessage = "Error Shm Reader: open() shared memory does not exist.";
+        return false;
+    }
+
+    // Map header first to get segment size.
+    void *map = mmap(nullptr, sizeof(HeaderStruct), PROT_READ, MAP_SHARED, fd, 0);
+
+    if(map == MAP_FAILED)
+    {
+        errorMessage = "Error Shm Reader: open() can not map shared memory.";
+        ::close(fd);
+        return false;
+    }
+
+    HeaderStruct header = *(const HeaderStruct*)map;
+    munmap(map, sizeof(HeaderStruct));
+
+    if( (header.magic != SHM_MAGIC) || (header.version != SHM_VERSION) || (header.sampleSize != sizeof(EAL580B_ShmSampleStruct)) )
+    {
+        errorMessage = "Error Shm Reader: open() shared memory format is not supported.";
+        ::close(fd);
+        return false;
+    }
+
+    _bytes = segmentBytes(header.slotNum, header.ringSize);
+    map = mmap(nullptr, _bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if(map == MAP_FAILED)
+    {
+        errorMessage = "Error Shm Reader: open() can not map shared memory.";
+        return false;
+    }
+
+    _map = (const uint8_t*)map;
+    _header = (const HeaderStruct*)_map;
+
+    return true;
+}
+
+void EAL580B_ShmReader::close(void)
+{
+    if(_map == nullptr)
+    {
+        return;
+    }
+
+    munmap((void*)_map, _bytes);
+
+    _map = nullptr;
+    _header = nullptr;
+}
+
+const SlotHeaderStruct* EAL580B_ShmReader::_slot(uint16_t slot) const
+{
+    if( (_header == nullptr) || (slot >= _header->slotNum) )
+    {
+        return nullptr;
+    }
+
+    return (const SlotHeaderStruct*)(_map + sizeof(HeaderStruct) + slot * _header->slotBytes);
+}
+
+bool EAL580B_ShmReader::readLatest(uint16_t slot, EAL580B_ShmSampleStruct &sample) const
+{
+    const SlotHeaderStruct *slotHeader = _slot(slot);
+
+    if(slotHeader == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t seq;
+
+    // A few retries are enough. Publisher holds an entry only for one copy.
+    for(int i = 0; i < 4; i++)
+    {
+        if(readEntry(slotHeader->latest, 0, sample, seq))
+        {
+            return seq != 0;
+        }
+    }
+
+    return false;
+}
+
+bool EAL580B_ShmReader::read(uint16_t slot, uint64_t &cursor, EAL580B_ShmSampleStruct &sample) const
+{
+    const SlotHeaderStruct *slotHeader = _slot(slot);
+
+    if(slotHeader == nullptr)
+    {
+        return false;
+    }
+
+    const EntryStruct *ring = (const EntryStruct*)((const uint8_t*)slotHeader + sizeof(SlotHeaderStruct));
+    uint64_t head = slotHeader->head.load(std::memory_order_acquire);
+
+    // Skip samples that are already overwritten.
+    if( (head > _header->ringSize) && (cursor < head - _header->ringSize) )
+    {
+        cursor = head - _header->ringSize;
+    }
+
+    while(cursor < head)
+    {
+        uint64_t seq;
+
+        if(readEntry(ring[cursor & (_header->ringSize - 1)], 2 * (cursor + 1), sample, seq))
+        {
+            cursor++;
+            return true;
+        }
+
+        // Overwritten while reading.
+        cursor++;
+    }
+
+    return false;
+}
+
+uint64_t EAL580B_ShmReader::getHead(uint16_t slot) const
+{
+    const SlotHeaderStruct *slotHeader = _slot(slot);
+
+    if(slotHeader == nullptr)
+    {
+        return 0;
+    }
+
+    return slotHeader->head.load(std::memory_order_acquire);
+}
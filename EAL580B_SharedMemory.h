@@ -0,0 +1,182 @@
+#ifndef _EAL580B_SHAREDMEMORY_H
+#define _EAL580B_SHAREDMEMORY_H
+
+// Header Includes:
+#include <stdint.h>                 // fixed width integer types
+#include <atomic>                   // For lock-free ring and seqlock
+#include <string>                   // For error message
+#include "EAL580B.h"                // EAL580B value struct
+
+// Hint: Link with -lrt on older glibc for shm_open.
+
+// #################################################################################
+
+namespace EAL580B_Namespace
+{
+    // Shared memory segment identification:
+    #define SHM_MAGIC                       0x4D485342      // 0:'B', 1:'S', 2:'H', 3:'M'
+    #define SHM_VERSION                     3
+}
+
+// #################################################################################
+
+/// One published encoder sample.
+struct EAL580B_ShmSampleStruct
+{
+    /// Host time of sample. [ns] Steady clock. (EAL580B::nowNs()) Same as value.timeNs.
+    uint64_t timeNs;
+
+    /// Ethercat slave id of the encoder.
+    int32_t slaveId;
+
+    EAL580B::ValueStruct value;
+};
+
+// #################################################################################
+/**
+ * @brief Layout of the shared memory segment. Used by publisher and reader.
+ * Segment = header + slotNum * (latest slot + ring of ringSize entries).
+ * @note All synchronization is done with lock-free atomics inside the segment. No system call after open.
+ */
+namespace EAL580B_ShmLayout
+{
+    struct HeaderStruct
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t slotNum;
+        uint32_t ringSize;
+        uint32_t sampleSize;
+        uint64_t slotBytes;
+        uint8_t reserved[40];
+    };
+
+    /// Seqlock protected sample. Sequence is odd while writing.
+    struct alignas(64) EntryStruct
+    {
+        std::atomic<uint64_t> seq;
+        EAL580B_ShmSampleStruct sample;
+    };
+
+    struct alignas(64) SlotHeaderStruct
+    {
+        /// Number of samples written to ring.
+        std::atomic<uint64_t> head;
+
+        /// Latest value. seq is the same counter as head.
+        EntryStruct latest;
+    };
+
+    /// Return size of one slot in bytes.
+    inline uint64_t slotBytes(uint32_t ringSize) {return sizeof(SlotHeaderStruct) + (uint64_t)ringSize * sizeof(EntryStruct);}
+
+    /// Return size of segment in bytes.
+    inline uint64_t segmentBytes(uint16_t slotNum, uint32_t ringSize) {return sizeof(HeaderStruct) + slotNum * slotBytes(ringSize);}
+}
+
+// #################################################################################
+/**
+ * @brief POSIX shared-memory publisher of encoder samples.
+ * Each encoder writes to one slot: a latest-value entry and a lock-free ring.
+ * One real-time process can serve many reader processes at full rate.
+ * @note Each slot must be written by only one thread.
+ */
+class EAL580B_ShmPublisher
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        /// @brief Default constructor.
+        EAL580B_ShmPublisher();
+
+        /// @brief Destructor. Close publisher.
+        ~EAL580B_ShmPublisher();
+
+        /**
+         * @brief Create and map shared memory segment. Do not use at cycle time.
+         * @param name is shared memory name. e.g. "/eal580b"
+         * @param slotNum is number of slots. (one for each encoder)
+         * @param ringSize is number of samples in ring of each slot. Must be power of 2.
+         * @return true if successed.
+         */
+        bool open(const char* name, uint16_t slotNum, uint32_t ringSize);
+
+        /**
+         * @brief Unmap segment.
+         * @param unlink: true -> also remove shared memory name.
+         */
+        void close(bool unlink = true);
+
+        /**
+         * @brief Publish one sample to slot. Only memory writes. No system call.
+         * @return false if not open or slot is out of range.
+         */
+        bool publish(uint16_t slot, int32_t slaveId, const EAL580B::ValueStruct &value);
+
+    private:
+
+        std::string _name;
+        uint8_t *_map;
+        uint64_t _bytes;
+        EAL580B_ShmLayout::HeaderStruct *_header;
+};
+
+// #################################################################################
+/**
+ * @brief Reader of shared memory published by EAL580B_ShmPublisher.
+ * Read functions are wait-free for the publisher and use no system call.
+ */
+class EAL580B_ShmReader
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        /// @brief Default constructor.
+        EAL580B_ShmReader();
+
+        /// @brief Destructor. Close reader.
+        ~EAL580B_ShmReader();
+
+        /**
+         * @brief Map shared memory segment read only.
+         * @return true if successed.
+         */
+        bool open(const char* name);
+
+        /// @brief Unmap segment.
+        void close(void);
+
+        /// @brief Return number of slots.
+        uint16_t getSlotNum(void) const {return (_header != nullptr) ? _header->slotNum : 0;}
+
+        /**
+         * @brief Read latest sample of slot.
+         * @return false if no sample published yet or publisher is writing too fast to get a consistent copy.
+         */
+        bool readLatest(uint16_t slot, EAL580B_ShmSampleStruct &sample) const;
+
+        /**
+         * @brief Read next sample of slot ring after cursor.
+         * @param cursor is reader position. Start with 0 or getHead(). Advanced past read or overwritten samples.
+         * @return false if no new sample.
+         */
+        bool read(uint16_t slot, uint64_t &cursor, EAL580B_ShmSampleStruct &sample) const;
+
+        /// @brief Return number of samples written to slot ring.
+        uint64_t getHead(uint16_t slot) const;
+
+    private:
+
+        const uint8_t *_map;
+        uint64_t _bytes;
+        const EAL580B_ShmLayout::HeaderStruct *_header;
+
+        // Return slot header. nullptr if slot is out of range.
+        const EAL580B_ShmLayout::SlotHeaderStruct* _slot(uint16_t slot) const;
+};
+
+#endif
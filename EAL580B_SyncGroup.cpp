@@ -0,0 +1,158 @@
+#include "EAL580B_SyncGroup.h"
+
+// #######################################################################
+
+using namespace EAL580B_Namespace;
+
+// #######################################################################
+
+EAL580B_SyncGroup::EAL580B_SyncGroup()
+{
+    parameters.SYNC0_CYCLE_NS = 1000000;
+    parameters.SYNC0_SHIFT_NS = 0;
+
+    _timeDC = 0;
+    _status = SAMPLE_VALID;
+}
+
+size_t EAL580B_SyncGroup::add(EAL580B* encoder)
+{
+    _encoders.push_back(encoder);
+    _pos.push_back(0);
+    _vel.push_back(0);
+
+    return _encoders.size() - 1;
+}
+
+int EAL580B_SyncGroup::addChannel(size_t a, size_t b, double gainA, double gainB)
+{
+    if( (a >= _encoders.size()) || (b >= _encoders.size()) )
+    {
+        errorMessage = "Error Encoder EAL580B: EAL580B_SyncGroup::addChannel() was not successed. Encoder index is not valid.";
+        return -1;
+    }
+
+    _indexA.push_back(a);
+    _indexB.push_back(b);
+    _gainA.push_back(gainA);
+    _gainB.push_back(gainB);
+    _posA.push_back(0);
+    _posB.push_back(0);
+    _velA.push_back(0);
+    _velB.push_back(0);
+    _diff.push_back(0);
+    _ratio.push_back(0);
+
+    return (int)_diff.size() - 1;
+}
+
+void EAL580B_SyncGroup::clear(void)
+{
+    _encoders.clear();
+    _pos.clear();
+    _vel.clear();
+    _indexA.clear();
+    _indexB.clear();
+    _gainA.clear();
+    _gainB.clear();
+    _posA.clear();
+    _posB.clear();
+    _velA.clear();
+    _velB.clear();
+    _diff.clear();
+    _ratio.clear();
+}
+
+bool EAL580B_SyncGroup::configDC(void)
+{
+    for(EAL580B* encoder : _encoders)
+    {
+        uint16_t id = encoder->parameters.ETHERCAT_ID;
+
+        if(!ec_slave[id].hasdc)
+        {
+            errorMessage = "Error Encoder EAL580B: EAL580B_SyncGroup::configDC() was not successed. Slave " + std::to_string(id) + " has no distributed clock.";
+            return false;
+        }
+    }
+
+    // Device sync type (0x1C33) and SYNC0 together. Encoder keeps the mode for reapply after reconnect.
+    for(EAL580B* encoder : _encoders)
+    {
+        if(!encoder->setSyncMode(SYNC_MODE_DC, parameters.SYNC0_CYCLE_NS, parameters.SYNC0_SHIFT_NS))
+        {
+            errorMessage = "Error Encoder EAL580B: EAL580B_SyncGroup::configDC() was not successed. Slave " +
+                           std::to_string(encoder->parameters.ETHERCAT_ID) + ": " + encoder->errorMessage;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void EAL580B_SyncGroup::disableDC(void)
+{
+    for(EAL580B* encoder : _encoders)
+    {
+        // SYNC0 is switched off even if the device does not take the free run mode.
+        if(!encoder->setSyncMode(SYNC_MODE_FREE_RUN, 0))
+        {
+            ec_dcsync0(encoder->parameters.ETHERCAT_ID, FALSE, 0, 0);
+        }
+    }
+}
+
+void EAL580B_SyncGroup::update(int wkc)
+{
+    // DC time of the frame of this cycle. All encoders sampled at SYNC0 of the same DC cycle.
+    _timeDC = ec_DCtime;
+    _status = SAMPLE_VALID;
+
+    for(size_t i = 0; i < _encoders.size(); i++)
+    {
+        EAL580B &encoder = *_encoders[i];
+
+        encoder.updateValuesPDO(wkc);
+
+        _pos[i] = encoder.value.posDeg;
+        _vel[i] = encoder.value.velDegSec;
+        _status |= encoder.value.status;
+    }
+
+    _updateChannels();
+}
+
+void EAL580B_SyncGroup::_updateChannels(void)
+{
+    const size_t num = _diff.size();
+
+    // Gather encoder values into channel arrays.
+    for(size_t k = 0; k < num; k++)
+    {
+        _posA[k] = _pos[_indexA[k]];
+        _posB[k] = _pos[_indexB[k]];
+        _velA[k] = _vel[_indexA[k]];
+        _velB[k] = _vel[_indexB[k]];
+    }
+
+    const double* posA = _posA.data();
+    const double* posB = _posB.data();
+    const double* velA = _velA.data();
+    const double* velB = _velB.data();
+    const double* gainA = _gainA.data();
+    const double* gainB = _gainB.data();
+    double* diff = _diff.data();
+    double* ratio = _ratio.data();
+
+    // Branch-free loops over contiguous arrays. The compiler vectorizes them.
+    for(size_t k = 0; k < num; k++)
+    {
+        diff[k] = gainA[k] * posA[k] - gainB[k] * posB[k];
+    }
+
+    for(size_t k = 0; k < num; k++)
+    {
+        double den = (velB[k] != 0.0) ? velB[k] : 1.0;
+        ratio[k] = (velB[k] != 0.0) ? (velA[k] / den) : 0.0;
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef _EAL580B_SYNCGROUP_H
+#define _EAL580B_SYNCGROUP_H
+
+// Header Includes:
+#include <vector>                   // For encoder and channel arrays
+#include "EAL580B.h"                // EAL580B encoder object
+
+// #################################################################################
+/**
+ * @brief Synchronized group of encoders. All encoders sample at the same Distributed Clocks SYNC0 event,
+ * so values of one cycle are simultaneous. Each group sample is tagged with the DC time of the cycle.
+ * Cross-encoder channels (e.g. torsion and backlash of a geared axis pair) are computed every cycle
+ * over structure-of-arrays buffers.
+ * @note The encoder samples at SYNC0 only in DC synchronous mode. In "Synchronous with SM3 Event" mode
+ * object 0x2201 must be set for a valid speed value (see EAL580B_objDict.h) and samples are not DC aligned.
+ */
+class EAL580B_SyncGroup
+{
+    public:
+
+        /// Last error accured for object.
+        std::string errorMessage;
+
+        struct ParameterStruct
+        {
+            /// SYNC0 cycle time. It should be the process data cycle time. [ns] Default: 1000000
+            uint32_t SYNC0_CYCLE_NS;
+
+            /// SYNC0 shift from DC cycle start. [ns] Default: 0
+            int32_t SYNC0_SHIFT_NS;
+
+        }parameters;
+
+        /// @brief Default constructor. Init parameters.
+        EAL580B_SyncGroup();
+
+        /**
+         * @brief Add encoder to group. Do not use at cycle time.
+         * @return Index of encoder in group.
+         */
+        size_t add(EAL580B* encoder);
+
+        /**
+         * @brief Add a cross-encoder channel. Do not use at cycle time.
+         * Difference: gainA * posDeg[a] - gainB * posDeg[b]. [deg]
+         * Ratio: velDegSec[a] / velDegSec[b]. 0 if speed of b is 0.
+         * @param a is index of first encoder in group.
+         * @param b is index of second encoder in group.
+         * @param gainA is gain of first encoder. e.g. gear ratio to common axis.
+         * @param gainB is gain of second encoder.
+         * @return Index of channel. -1 if encoder index is not valid.
+         */
+        int addChannel(size_t a, size_t b, double gainA = 1.0, double gainB = 1.0);
+
+        /// @brief Remove all encoders and channels.
+        void clear(void);
+
+        /// @brief Return number of encoders.
+        size_t size(void) const {return _encoders.size();}
+
+        /// @brief Return number of channels.
+        size_t channels(void) const {return _diff.size();}
+
+        /**
+         * @brief Set DC sync mode for all encoders of group with EAL580B::setSyncMode(). (0x1C33 and SYNC0)
+         * @note Use in PRE_OP after ethercat configdc() and before request of SAFE_OP state. (SDO access)
+         * @return true if successed. Otherwise errorMessage holds the failed slave. Encoders before it are in DC mode.
+         */
+        bool configDC(void);
+
+        /// @brief Set free run sync mode for all encoders of group and disable SYNC0. (SDO access)
+        void disableDC(void);
+
+        /**
+         * @brief Update all encoders in PDO mode and compute channels.
+         * @note Use in process data thread after ec_receive_processdata().
+         * @param wkc is working counter returned by ec_receive_processdata() of this cycle.
+         */
+        void update(int wkc);
+
+        /// @brief Return DC time of last group sample. [ns] since 2000-01-01. (ec_DCtime)
+        int64_t getTimeDC(void) const {return _timeDC;}
+
+        /// @brief Return OR of SAMPLE_xxx status of all encoders in last group sample.
+        uint8_t getStatus(void) const {return _status;}
+
+        /// @brief Return position array of last group sample. Index is encoder index. [deg]
+        const double* getPositions(void) const {return _pos.data();}
+
+        /// @brief Return speed array of last group sample. Index is encoder index. [deg/s]
+        const double* getSpeeds(void) const {return _vel.data();}
+
+        /// @brief Return difference array of channels. [deg]
+        const double* getDifferences(void) const {return _diff.data();}
+
+        /// @brief Return ratio array of channels.
+        const double* getRatios(void) const {return _ratio.data();}
+
+    private:
+
+        std::vector<EAL580B*> _encoders;
+
+        // Values of encoders. Index is encoder index.
+        std::vector<double> _pos;
+        std::vector<double> _vel;
+
+        // Channel definitions. Index is channel index.
+        std::vector<size_t> _indexA;
+        std::vector<size_t> _indexB;
+        std::vector<double> _gainA;
+        std::vector<double> _gainB;
+
+        // Gathered channel inputs. Contiguous, so channel loops vectorize.
+        std::vector<double> _posA;
+        std::vector<double> _posB;
+        std::vector<double> _velA;
+        std::vector<double> _velB;
+
+        // Channel outputs.
+        std::vector<double> _diff;
+        std::vector<double> _ratio;
+
+        int64_t _timeDC;
+
+        uint8_t _status;
+
+        // Compute all channels from _pos and _vel.
+        void _updateChannels(void);
+};
+
+#endif
@@ -1,3 +1,7 @@
+#ifndef _EAL580B_OBJDICT_H
+#define _EAL580B_OBJDICT_H
+
+#include <stdint.h>                 // fixed width integer types
 
 // Basic commands order
 #define SAVE        0x65766173  // 0:'S', 1:'A', 2:'V', 3:'E'
@@ -42,11 +46,21 @@
 #define Index_TPDOmapping_6                         0x1A05
 #define Index_TPDOmapping_7                         0x1A06
 
+// Identity Object
+// This object contains vendor id (subindex 1), product code (2), revision number (3) and serial number (4) of the encoder.
+#define Index_IdentityObject                        0x1018
+
 // Sync Manager 3 PDO Assignment
 // This object is used to configure the layout of the cyclic EtherCAT process data which is sent from 
 // slave to master. Object 0x1C13 contains the PDO assignment which is currently active.
 #define Index_SyncManager3PDOAssignment             0x1C13
 
+// Sync Manager 3 Parameter
+// This object configures the synchronization of the input process data.
+// Subindex 1: synchronization type. 0x00: Free Run, 0x01: Synchronous with SM3 Event, 0x02: DC SYNC0.
+// Subindex 2: cycle time [ns], 3: shift time from SYNC0 to input latch [ns], 4: supported synchronization types,
+// 5: minimum cycle time [ns], 6: calc and copy time [ns], 12: cycle time too small counter, 32: sync error.
+#define Index_SyncManager3Parameter                 0x1C33
 
 
 // ######################################################################
@@ -81,6 +95,11 @@
 // This object contains the signed sensor temperature in degrees Celsius.
 #define Index_SensorTemperature                     0x2120
 
+// Speed Calculation Cycle Time
+// This object contains the process data cycle time the speed calculation is based on in mode 
+// "Synchronous with SM3 Event". [us] It has to match the cycle time of the master for a valid speed value (0x2004).
+#define Index_SpeedCalculationCycleTime             0x2201
+
 // #######################################################################
 // Profile-specific CoE objects (index range 0x6000 to 0xFFFF)
 
@@ -122,4 +141,79 @@
 // Offset value
 // This object contains the preset offset of the encoder. The value of this object is calculated when 
 // object 0x6003 (preset) is written or when a preset is triggered via the push button.
-#define Index_OffsetValue                           0x6509
\ No newline at end of file
+#define Index_OffsetValue                           0x6509
+
+// #######################################################################
+// Typed object descriptors.
+// Each object carries index, subindex, C++ type and access rights at compile time.
+// Use with EAL580B::readObject<>() and EAL580B::writeObject<>(). e.g.:
+// int32_t temperature; encoder.readObject<EAL580B_OD::SensorTemperature>(&temperature);
+
+namespace EAL580B_OD
+{
+    // Object access rights:
+    #define OD_ACCESS_RO                    0x01
+    #define OD_ACCESS_WO                    0x02
+    #define OD_ACCESS_RW                    0x03
+
+    /**
+     * @brief Compile-time descriptor of one CoE object entry.
+     * @note Only fixed size types up to 4 bytes. (expedited SDO transfer)
+     */
+    template<typename T, uint16_t INDEX, uint8_t SUBINDEX, uint8_t ACCESS>
+    struct Object
+    {
+        static_assert(sizeof(T) <= 4, "Only objects up to 4 bytes are supported.");
+
+        using Type = T;
+
+        static constexpr uint16_t index = INDEX;
+        static constexpr uint8_t subindex = SUBINDEX;
+        static constexpr int size = sizeof(T);
+        static constexpr bool readable = (ACCESS & OD_ACCESS_RO) != 0;
+        static constexpr bool writable = (ACCESS & OD_ACCESS_WO) != 0;
+    };
+
+    // Standard CoE objects:
+    using ErrorRegister                     = Object<uint8_t,  Index_ErrorRegister,                     0, OD_ACCESS_RO>;
+    using VendorId                          = Object<uint32_t, Index_IdentityObject,                    1, OD_ACCESS_RO>;
+    using ProductCode                       = Object<uint32_t, Index_IdentityObject,                    2, OD_ACCESS_RO>;
+    using RevisionNumber                    = Object<uint32_t, Index_IdentityObject,                    3, OD_ACCESS_RO>;
+    using SerialNumber                      = Object<uint32_t, Index_IdentityObject,                    4, OD_ACCESS_RO>;
+    using SaveParameters                    = Object<uint32_t, Index_SaveParameters,                    1, OD_ACCESS_RW>;
+    using RestoreParameters                 = Object<uint32_t, Index_RestoreParameters,                 1, OD_ACCESS_RW>;
+    using SyncManager3PDOAssignmentNum      = Object<uint8_t,  Index_SyncManager3PDOAssignment,         0, OD_ACCESS_RW>;
+    using SyncManager3PDOAssignment         = Object<uint16_t, Index_SyncManager3PDOAssignment,         1, OD_ACCESS_RW>;
+    using SyncType                          = Object<uint16_t, Index_SyncManager3Parameter,             1, OD_ACCESS_RW>;
+    using SyncCycleTime                     = Object<uint32_t, Index_SyncManager3Parameter,             2, OD_ACCESS_RW>;
+    using SyncShiftTime                     = Object<uint32_t, Index_SyncManager3Parameter,             3, OD_ACCESS_RO>;
+    using SyncTypesSupported                = Object<uint16_t, Index_SyncManager3Parameter,             4, OD_ACCESS_RO>;
+    using SyncMinCycleTime                  = Object<uint32_t, Index_SyncManager3Parameter,             5, OD_ACCESS_RO>;
+    using SyncCalcCopyTime                  = Object<uint32_t, Index_SyncManager3Parameter,             6, OD_ACCESS_RO>;
+    using SyncCycleTimeTooSmall             = Object<uint16_t, Index_SyncManager3Parameter,             12, OD_ACCESS_RO>;
+    using SyncError                         = Object<uint8_t,  Index_SyncManager3Parameter,             32, OD_ACCESS_RO>;
+
+    // Vendor-specific CoE objects:
+    using SystemTime                        = Object<uint32_t, Index_SystemTime,                        0, OD_ACCESS_RO>;
+    using GearFactorEnable                  = Object<uint16_t, Index_GearFactorConfiguration,           1, OD_ACCESS_RW>;
+    using GearFactorNumerator               = Object<uint32_t, Index_GearFactorConfiguration,           2, OD_ACCESS_RW>;
+    using GearFactorDenominator             = Object<uint32_t, Index_GearFactorConfiguration,           3, OD_ACCESS_RW>;
+    using SpeedMeasuringUnit                = Object<uint8_t,  Index_SpeedCalculationConfiguration,     2, OD_ACCESS_RW>;
+    using PositionValue2Bytes               = Object<uint16_t, Index_PositionValue2Bytes,               0, OD_ACCESS_RO>;
+    using SpeedValue4Bytes                  = Object<int32_t,  Index_SpeedValue4Bytes,                  0, OD_ACCESS_RO>;
+    using SensorTemperature                 = Object<int32_t,  Index_SensorTemperature,                 0, OD_ACCESS_RO>;
+    using SpeedCalculationCycleTime         = Object<uint32_t, Index_SpeedCalculationCycleTime,         0, OD_ACCESS_RW>;
+
+    // Profile-specific CoE objects:
+    using OperatingParameters               = Object<uint16_t, Index_OperatingParameters,               0, OD_ACCESS_RW>;
+    using MeasuringUnitsPerRevolution       = Object<uint32_t, Index_MeasuringUnitsPerRevolution,       0, OD_ACCESS_RW>;
+    using TotalMeasuringRange               = Object<uint32_t, Index_TotalMeasuringRange,               0, OD_ACCESS_RW>;
+    using PresetValue                       = Object<uint32_t, Index_PresetValue,                       0, OD_ACCESS_RW>;
+    using PositionValue                     = Object<uint32_t, Index_PositionValue,                     0, OD_ACCESS_RO>;
+    using PositionRawValue                  = Object<uint32_t, Index_PositionRawValue,                  0, OD_ACCESS_RO>;
+    using SingleTurnResolution              = Object<uint32_t, Index_SingleTurnResolution,              0, OD_ACCESS_RO>;
+    using NumberOfDistinguishableRevolutions = Object<uint32_t, Index_NumberOfDistinguishableRevolutions, 0, OD_ACCESS_RO>;
+    using OffsetValue                       = Object<int32_t,  Index_OffsetValue,                       0, OD_ACCESS_RO>;
+}
+
+#endif
@@ -0,0 +1,77 @@
+// For compile:
+// g++ -O2 -o positionCompare_benchmark ./positionCompare_benchmark.cpp ../EAL580B_PositionCompare.cpp -Wall -Wextra -std=c++17
+
+// For run:
+// ./positionCompare_benchmark
+
+// ###############################################
+// Header Includes:
+#include <iostream>
+#include <chrono>
+#include "../EAL580B_PositionCompare.h"
+
+// ############################################################################
+// Define macros:
+
+#define WINDOW_NUM                   10000
+#define CYCLE_NUM                    1000000
+
+// Position step for each cycle. [deg]
+#define CYCLE_STEP_DEG               0.37
+
+// ###############################################
+// Global Variables and objects:
+
+EAL580B_PositionCompare positionCompare;
+
+// #################################################
+
+int main(void)
+{
+    // Windows with 1 deg width each 3.6 deg. So 10k windows cover 100 revolutions.
+    for(uint32_t i = 0; i < WINDOW_NUM; i++)
+    {
+        positionCompare.addWindow(i, 3.6 * i, 3.6 * i + 1.0);
+    }
+
+    positionCompare.build();
+
+    printf("Edges indexed: %d\n", positionCompare.getEdgeCount());
+
+    const double range = 3.6 * WINDOW_NUM;
+
+    double pos = 0;
+    double dir = 1;
+    uint64_t eventSum = 0;
+
+    std::chrono::time_point<std::chrono::steady_clock> start, end;
+
+    start = std::chrono::steady_clock::now();
+
+    for(uint32_t cycle = 0; cycle < CYCLE_NUM; cycle++)
+    {
+        pos += dir * CYCLE_STEP_DEG;
+
+        if( (pos >= range) || (pos <= 0) )
+        {
+            dir = -dir;
+        }
+
+        eventSum += positionCompare.update(pos);
+    }
+
+    end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+
+    printf("Cycles: %d, Events: %lu, Overflow: %d\n", CYCLE_NUM, (unsigned long)eventSum, positionCompare.getOverflowCount());
+    printf("Time per cycle: %f [ns]\n", 1e9 * elapsed_seconds.count() / CYCLE_NUM);
+
+    // Skip over many windows in one sample. All skipped enter/leave crossings must be reported.
+    positionCompare.reset();
+    positionCompare.update(0.5);
+    uint16_t n = positionCompare.update(36.5);
+    printf("Jump 0.5 -> 36.5 [deg] events: %d (expect 20)\n", n);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+// For compile:
+// g++ -o recorder2csv ./recorder2csv.cpp -Wall -Wextra -std=c++17
+
+// For run:
+// ./recorder2csv record_0.bin record_1.bin ... > record.csv
+
+// ###############################################
+// Header Includes:
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include "../EAL580B_Recorder.h"
+
+// ###############################################
+// Global Variables and objects:
+
+using namespace EAL580B_Namespace;
+
+struct SegmentStruct
+{
+    EAL580B_Recorder::SegmentHeaderStruct header;
+    std::vector<EAL580B_Recorder::RecordStruct> records;
+};
+
+// #################################################
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        printf("Usage: %s <segment files ...>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<SegmentStruct> segments;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::ifstream file(argv[i], std::ios::binary);
+
+        SegmentStruct segment;
+
+        if(!file.read((char*)&segment.header, sizeof(segment.header)))
+        {
+            fprintf(stderr, "Can not read header of %s\n", argv[i]);
+            continue;
+        }
+
+        if( (segment.header.magic != RECORDER_MAGIC) || (segment.header.recordSize != sizeof(EAL580B_Recorder::RecordStruct)) )
+        {
+            fprintf(stderr, "%s is not a recorder segment of version %d\n", argv[i], RECORDER_VERSION);
+            continue;
+        }
+
+        // Sequence 0 means segment was never used.
+        if(segment.header.sequence == 0)
+        {
+            continue;
+        }
+
+        uint64_t count = std::min<uint64_t>(segment.header.recordCount, segment.header.capacity);
+
+        segment.records.resize(count);
+        file.read((char*)segment.records.data(), count * sizeof(EAL580B_Recorder::RecordStruct));
+        segment.records.resize(file.gcount() / sizeof(EAL580B_Recorder::RecordStruct));
+
+        segments.push_back(std::move(segment));
+    }
+
+    // Oldest segment first.
+    std::sort(segments.begin(), segments.end(), [](const SegmentStruct &a, const SegmentStruct &b)
+    {
+        return a.header.sequence < b.header.sequence;
+    });
+
+    printf("timeNs,slaveId,posStep,posRawStep,velStep,status\n");
+
+    for(const SegmentStruct &segment : segments)
+    {
+        for(const EAL580B_Recorder::RecordStruct &record : segment.records)
+        {
+            printf("%llu,%u,%u,%u,%d,%u\n", (unsigned long long)record.timeNs, record.slaveId, record.posStep, record.posRawStep, record.velStep, record.status);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+// For compile:
+// g++ -O2 -o replay ./replay.cpp ../*.cpp -lsoem -Wall -Wextra -std=c++17
+
+// For run:
+// ./replay <slave id> <single turn resolution> <total measuring range> record_0.bin record_1.bin ...
+
+// ###############################################
+// Header Includes:
+#include <iostream>
+#include <chrono>
+#include "../EAL580B.h"
+
+// ############################################################################
+// Define macros:
+
+// Replay at recorded timing (1) or as fast as possible (0).
+#define ORIGINAL_TIMING              0
+
+// ###############################################
+// Global Variables and objects:
+
+EAL580B encoder;
+EAL580B_Replay replay;
+
+// #################################################
+
+int main(int argc, char** argv)
+{
+    if(argc < 5)
+    {
+        printf("Usage: %s <slave id> <single turn resolution> <total measuring range> <segment files ...>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> files(argv + 4, argv + argc);
+
+    if(!replay.open(files, (uint16_t)atoi(argv[1])))
+    {
+        std::cout << replay.errorMessage << std::endl;
+        return 1;
+    }
+
+    replay.setTiming(ORIGINAL_TIMING);
+
+    // Parameters must be same as recording time.
+    encoder.parameters.ETHERCAT_ID = atoi(argv[1]);
+    encoder.parameters.PDOMAP_CONFIG_TYPE = 2;
+    encoder.parameters.SPD_UNIT = SPD_UNIT_STEP_1000MS;
+
+    if(!encoder.initReplay(&replay, (uint32_t)atoi(argv[2]), (uint32_t)atoi(argv[3])))
+    {
+        std::cout << encoder.errorMessage << std::endl;
+        return 1;
+    }
+
+    std::chrono::time_point<std::chrono::steady_clock> start, end;
+
+    start = std::chrono::steady_clock::now();
+
+    double posSum = 0;
+
+    while(replay.next())
+    {
+        encoder.updateValuesPDO();
+        posSum += encoder.value.posDeg;
+    }
+
+    end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+
+    printf("Records: %lu, Time per sample: %f [ns], Mean pos: %f [deg]\n", (unsigned long)replay.getRecordCount(),
+           1e9 * elapsed_seconds.count() / replay.getRecordCount(), posSum / replay.getRecordCount());
+
+    return 0;
+}